@@ -8,6 +8,8 @@
 #include "Camera.h"
 #include "Scene.h" 
 #include "ShaderManager.h" 
+#include "AssetRegistry.h"
+#include "QualityGovernor.h"
 
 class Application {
 public:
@@ -16,6 +18,7 @@ public:
     static constexpr int DEFAULT_HEIGHT = 720;
     static constexpr float MOUSE_SENSITIVITY = 0.1f;
     static constexpr float CAMERA_SPEED = 5.0f;
+    static constexpr float STATS_INTERVAL = 2.0f; //     ()
 
     Application(int width = DEFAULT_WIDTH, int height = DEFAULT_HEIGHT, const std::string& title = "OpenGL/SFML Renderer");
 
@@ -27,15 +30,24 @@ private:
     sf::RenderWindow window;
 
     // ---   ---
+    //   ,   
+    std::unique_ptr<AssetRegistry> assetRegistry;
     std::unique_ptr<Scene> scene;
     std::unique_ptr<Camera> camera;
     std::unique_ptr<ShaderManager> shaderManager;
 
+    //   (        )
+    std::unique_ptr<QualityGovernor> governor;
+
     // ---   ---
     bool firstMouse;
     float lastX;
     float lastY;
 
+    // ---   (  ) ---
+    float statsTime;
+    int statsFrames;
+
     // ---   ---
 
     //  SFML  OpenGL/GLEW
@@ -49,4 +61,7 @@ private:
 
     //  
     void render();
+
+    //          
+    void reportFrameStats(float deltaTime);
 };
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Mesh.h"
+#include "Texture.h"
+#include "Material.h"
+#include "Shader.h"
+
+/**
+ * @brief  ,   ( ).
+ */
+enum class AssetType {
+    MESH,
+    TEXTURE,
+    MATERIAL,
+    SHADER,
+    COUNT
+};
+
+/**
+ * @brief    (Mesh, Texture, Material, Shader).
+ *        , 
+ *      (     )
+ *       VBO//.
+ *
+ *    weak_ptr:  ,      
+ *   ,   ,    .
+ */
+class AssetRegistry {
+public:
+    //        
+    struct Stats {
+        size_t hits = 0;    //    
+        size_t misses = 0;  //   
+        size_t live = 0;    //   () 
+    };
+
+    AssetRegistry() = default;
+
+    //  
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+    // ---   ---
+
+    /**
+     * @brief  OBJ-    .
+     * @param filePath    .obj.
+     * @throws std::runtime_error      .
+     */
+    std::shared_ptr<Mesh> loadMesh(const std::string& filePath);
+
+    /**
+     * @brief     (. MeshParser::parseCubeAsPlatform).
+     *     ,        .
+     */
+    std::shared_ptr<Mesh> loadPlatformMesh(const std::string& filePath,
+                                           float scaleX = 5.0f,
+                                           float scaleY = 0.2f,
+                                           float scaleZ = 3.0f);
+
+    /**
+     * @brief      .
+     * @param filePath   .
+     * @param flipVertically    (  ).
+     */
+    std::shared_ptr<Texture> loadTexture(const std::string& filePath, bool flipVertically = true);
+
+    /**
+     * @brief     ,     .
+     * :       ,
+     *         .
+     */
+    std::shared_ptr<Material> getMaterial(const Vec3& ambient, const Vec3& diffuse, const Vec3& specular,
+                                          float shininess, std::shared_ptr<Texture> texture,
+                                          LightingModel lightingModel);
+
+    /**
+     * @brief       .
+     * @param vertexPath    .
+     * @param fragmentPath    .
+     * @param binaryCache   ,    (  nullptr).
+     * @param defines #define  ;     .
+     * @param asynchronous  ,     (. Shader::isReady()).
+     */
+    std::shared_ptr<Shader> loadShader(const std::string& vertexPath, const std::string& fragmentPath,
+                                       class ProgramBinaryCache* binaryCache = nullptr,
+                                       const std::string& defines = "", bool asynchronous = false);
+
+    /**
+     * @brief    (separable program)   
+     * (ShaderStage::COMPUTE)    .
+     *      (, base.vert)      .
+     */
+    std::shared_ptr<Shader> loadShaderStage(ShaderStage stage, const std::string& path,
+                                            class ProgramBinaryCache* binaryCache = nullptr,
+                                            const std::string& defines = "", bool asynchronous = false);
+
+    // ---  ---
+
+    //      ,    
+    void collectGarbage();
+
+    //    
+    Stats getStats(AssetType type) const;
+
+    //   /  
+    void printStats() const;
+
+    // ---   ---
+
+    //   (,  "..", "."   )
+    static std::string canonicalPath(const std::string& filePath);
+
+    // 64- FNV-1a 
+    static uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+    //   
+    static uint64_t hashFile(const std::string& filePath);
+
+private:
+    //    :       
+    template <typename T>
+    struct Cache {
+        std::map<std::string, std::weak_ptr<T>> byPath;
+        std::map<uint64_t, std::weak_ptr<T>> byContent;
+    };
+
+    Cache<Mesh> meshes;
+    Cache<Texture> textures;
+    Cache<Shader> shaders;
+    std::map<uint64_t, std::weak_ptr<Material>> materials;
+
+    std::array<Stats, static_cast<size_t>(AssetType::COUNT)> stats{};
+
+    /**
+     * @brief   :   ,    ,  .
+     * @param pathKey        .
+     * @param contentHash     (     ).
+     * @param load   .
+     */
+    template <typename T>
+    std::shared_ptr<T> acquire(Cache<T>& cache, AssetType type, const std::string& pathKey,
+                               const std::function<uint64_t()>& contentHash,
+                               const std::function<std::shared_ptr<T>()>& load);
+
+    Stats& statsFor(AssetType type) { return stats[static_cast<size_t>(type)]; }
+};
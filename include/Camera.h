@@ -2,6 +2,7 @@
 
 #include <SFML/Window/Keyboard.hpp>
 #include <SFML/System/Vector3.hpp>
+#include "Frustum.h"
 
 //   
 using Vec3 = sf::Vector3f;
@@ -64,6 +65,9 @@ public:
     //    (Projection Matrix)
     void getProjectionMatrix(float projectionMatrix[16]) const;
 
+    //    (  projection * view;    )
+    void getFrustum(Frustum& frustum) const;
+
     //    
     void processKeyboard(CameraMovement direction, float deltaTime);
 
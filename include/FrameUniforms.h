@@ -0,0 +1,103 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "Shader.h"
+
+/**
+ * @brief  ,    :    .
+ *
+ *   uniform- (std140)      
+ * (CAMERA_BLOCK_BINDING, LIGHTS_BLOCK_BINDING),   phong, toon, custom,
+ *   base.vert.         
+ *    .
+ *
+ *     std140  CameraData  LightData  
+ * (vec3   16 ,      vec3).
+ */
+class FrameUniforms {
+public:
+    // ---   CameraData ---
+    struct CameraBlock {
+        float view[16];
+        float projection[16];
+        float viewPos[3];
+        float pad0;
+    };
+
+    // ---   LightData ---
+    struct DirLightBlock {
+        float direction[3];
+        float pad0;
+        float color[3];
+        float ambientIntensity;
+    };
+
+    struct PointLightBlock {
+        float position[3];
+        float pad0;
+        float color[3];
+        float constant;
+        float linear;
+        float quadratic;
+        float pad1[2];
+    };
+
+    struct SpotLightBlock {
+        float position[3];
+        float pad0;
+        float direction[3];
+        float pad1;
+        float color[3];
+        float cutOff;
+        float outerCutOff;
+        float constant;
+        float linear;
+        float quadratic;
+    };
+
+    struct LightBlock {
+        DirLightBlock dirLight;
+        PointLightBlock pointLights[MAX_POINT_LIGHTS];
+        SpotLightBlock spotLights[MAX_SPOT_LIGHTS];
+        int numPointLights;
+        int numSpotLights;
+        int pad0[2];
+    };
+
+    //   (     GPU)
+    struct Stats {
+        size_t uploads = 0;
+        size_t skipped = 0;
+    };
+
+    /**
+     * @brief .          .
+     *    OpenGL.
+     */
+    FrameUniforms();
+    ~FrameUniforms();
+
+    //   (  OpenGL)
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    /**
+     * @brief   . ,    , .
+     */
+    void update(const CameraBlock& camera, const LightBlock& lights);
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    GLuint bufferID = 0;
+
+    //      ( GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+    GLintptr lightsOffset = 0;
+
+    //    (  )
+    CameraBlock uploadedCamera{};
+    LightBlock uploadedLights{};
+    bool hasUploaded = false;
+
+    Stats stats;
+};
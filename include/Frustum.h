@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief  :   ax + by + cz + d >= 0 ( ).
+ *  ,    -   .
+ */
+struct Frustum {
+    enum PlaneIndex { LEFT, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+    float planes[PLANE_COUNT][4];
+
+    /**
+     * @brief     projection * view ( Gribb-Hartmann).
+     * @param viewProjection  4x4  ,    .
+     */
+    void extract(const float viewProjection[16]);
+};
+
+/**
+ * @brief      .
+ *
+ *       ( X, Y, Z   )  
+ *   8 (AVX)   4 (SSE)  ;  SIMD- -  .
+ *     8 ,      .
+ */
+class FrustumCuller {
+public:
+    struct Stats {
+        size_t tested = 0;
+        size_t culled = 0;
+    };
+
+    //    (      setSphere)
+    void resize(size_t count);
+    size_t size() const { return count; }
+
+    void setSphere(size_t index, float centerX, float centerY, float centerZ, float radius);
+
+    /**
+     * @brief     .
+     * @param frustum   .
+     * @param visible : 1 -     , 0 -  ( = size()).
+     * @return   .
+     */
+    size_t cull(const Frustum& frustum, std::vector<uint8_t>& visible);
+
+    const Stats& getStats() const { return stats; }
+
+    //     ( )
+    static const char* instructionSet();
+
+private:
+    static constexpr size_t LANES = 8;
+
+    size_t count = 0;
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    Stats stats;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief    OpenGL,     .
+ *
+ *    , , VAO,   ,  
+ *   glEnable. ,    ,     
+ *     .
+ *
+ *  ,       . , 
+ *  gl*   ,     invalidate().
+ *     (forget*),       
+ *    .
+ */
+class GLStateCache {
+public:
+    //        
+    static constexpr GLuint MAX_TEXTURE_UNITS = 16;
+    static constexpr GLuint MAX_BUFFER_BINDINGS = 16;
+
+    struct Counter {
+        size_t issued = 0;   // ,  
+        size_t skipped = 0;  //  ,  
+    };
+
+    struct Stats {
+        Counter programs;       // glUseProgram, glBindProgramPipeline, glUseProgramStages
+        Counter vertexArrays;   // glBindVertexArray
+        Counter textures;       // glActiveTexture, glBindTexture
+        Counter buffers;        // glBindBuffer, glBindBufferRange, glBindBufferBase
+        Counter capabilities;   // glEnable, glDisable
+
+        size_t totalIssued() const;
+        size_t totalSkipped() const;
+    };
+
+    //    (    )
+    static GLStateCache& get();
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    // ---  ---
+
+    void useProgram(GLuint program);
+    void bindProgramPipeline(GLuint pipeline);
+    void useProgramStages(GLuint pipeline, GLbitfield stages, GLuint program);
+
+    // ---   ---
+
+    void bindVertexArray(GLuint vao);
+
+    // ---  ---
+
+    //    ( )     .
+    //     :       
+    void bindTexture(GLuint unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
+
+    // ---  ---
+
+    // GL_ELEMENT_ARRAY_BUFFER -   VAO   
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // ---  ---
+
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+
+    // ---   ---
+
+    void forgetProgram(GLuint program);
+    void forgetProgramPipeline(GLuint pipeline);
+    void forgetVertexArray(GLuint vao);
+    void forgetTexture(GLuint texture);
+    void forgetBuffer(GLuint buffer);
+
+    //   :       
+    void invalidate();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    GLStateCache();
+
+    //  :        OpenGL
+    static constexpr GLuint UNKNOWN = ~0u;
+
+    struct IndexedBinding {
+        GLuint buffer = UNKNOWN;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;  // 0 -    (glBindBufferBase)
+    };
+
+    struct PipelineStages {
+        GLuint vertex = UNKNOWN;
+        GLuint fragment = UNKNOWN;
+    };
+
+    GLuint program = UNKNOWN;
+    GLuint pipeline = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+
+    GLuint activeUnit = UNKNOWN;
+    GLuint textures[MAX_TEXTURE_UNITS];
+
+    //    (GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, ...)   GL_UNIFORM_BUFFER
+    std::unordered_map<GLenum, GLuint> buffers;
+    IndexedBinding uniformBindings[MAX_BUFFER_BINDINGS];
+
+    std::unordered_map<GLuint, PipelineStages> pipelineStages;
+    std::vector<std::pair<GLenum, bool>> capabilities;
+
+    Stats stats;
+
+    void setCapability(GLenum capability, bool enabled);
+};
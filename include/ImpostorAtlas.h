@@ -0,0 +1,97 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include "Mesh.h"
+
+class Shader;
+class Texture;
+
+/**
+ * @brief   (impostors)    (. Scene::setImpostorThreshold).
+ *
+ *    (,  )      GRID x GRID :
+ *      ,   
+ * ( ,   (i, j) - frameDirection(i, j)).  :
+ *  - ALBEDO:       RGBA8   -    (  ),  - ;
+ *  - NORMAL_DEPTH: RGBA16F -     (xyz,   0..1)
+ *                               (w: 0 -      , 1 - ).
+ *
+ *      (impostor.vert)   , 
+ *    .        ,
+ *      ,    (uber.frag / gbuffer.frag  #define IMPOSTOR):
+ *      -    .
+ *      ,      .
+ */
+class ImpostorAtlas {
+public:
+    //      (   ATLAS_GRID  impostor.vert)
+    static constexpr int GRID = 8;
+
+    //    
+    static constexpr int FRAME_SIZE = 64;
+    static constexpr int ATLAS_SIZE = GRID * FRAME_SIZE;
+
+    //       (  , . Scene::SCENE_COLOR_UNIT)
+    static constexpr unsigned int ALBEDO_UNIT = 11;
+    static constexpr unsigned int NORMAL_DEPTH_UNIT = 12;
+
+    struct Impostor {
+        GLuint albedo = 0;
+        GLuint normalDepth = 0;
+        float bounds[4] = {};    //    :  (xyz)   (w)
+    };
+
+    struct Stats {
+        size_t impostors = 0;      //  
+        size_t textureBytes = 0;
+        size_t bakeDrawCalls = 0;  //     (    )
+    };
+
+    //       VAO  (  OpenGL)
+    ImpostorAtlas();
+    ~ImpostorAtlas();
+
+    //   (  OpenGL)
+    ImpostorAtlas(const ImpostorAtlas&) = delete;
+    ImpostorAtlas& operator=(const ImpostorAtlas&) = delete;
+
+    /**
+     * @brief   (, );    .
+     *           .
+     * @param bakeShader  impostor_bake.vert + impostor_bake.frag.
+     * @throws std::runtime_error     .
+     */
+    const Impostor& acquire(const Mesh& mesh, const Texture* texture, Shader& bakeShader);
+
+    //      nullptr
+    const Impostor* find(const Mesh& mesh, const Texture* texture) const;
+
+    //      ALBEDO_UNIT  NORMAL_DEPTH_UNIT
+    void bind(const Impostor& impostor) const;
+
+    //  count  (  4   ,    impostor.vert)
+    void drawBillboards(int count) const;
+
+    const Stats& getStats() const { return stats; }
+
+    //      (i, j)    (octDecode  impostor.vert)
+    static Vec3 frameDirection(int i, int j);
+
+private:
+    std::map<std::pair<const Mesh*, const Texture*>, Impostor> impostors;
+
+    //    (      )   
+    GLuint framebuffer = 0;
+    GLuint depthBuffer = 0;
+
+    //     ,  core-   VAO
+    GLuint emptyVertexArray = 0;
+
+    Stats stats;
+
+    //      
+    void bake(const Mesh& mesh, const Texture* texture, Shader& bakeShader, Impostor& impostor);
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Mesh.h"
+#include "Frustum.h"
+
+class Shader;
+class Texture;
+
+/**
+ * @brief ,  GPU ( RenderMode::GPU_DRIVEN).
+ *
+ *             ( VAO),
+ *     -    (SSBO): ,   ,
+ * ,    .   (cull.comp)  
+ *        DrawElementsIndirectCommand,    ;
+ *    instanceCount = 0.    glMultiDrawElementsIndirect
+ *    (     ),   indirect.vert
+ *     drawBase + gl_DrawIDARB.
+ *
+ * CPU       (addObject)    ;
+ *   CPU  .      , 
+ *  :      .
+ *
+ *  OpenGL 4.3 ( , SSBO, ARB_multi_draw_indirect)
+ *  ARB_shader_draw_parameters (gl_DrawIDARB), . isSupported().
+ */
+class IndirectRenderer {
+public:
+    //    cull.comp (   local_size_x)
+    static constexpr GLuint CULL_GROUP_SIZE = 64;
+
+    struct Stats {
+        size_t objects = 0;          //    (    GPU)
+        size_t multiDrawCalls = 0;   //  glMultiDrawElementsIndirect
+        size_t meshes = 0;           //     
+        size_t geometryBytes = 0;
+    };
+
+    //    ,  
+    static bool isSupported();
+
+    //    OpenGL
+    IndirectRenderer();
+    ~IndirectRenderer();
+
+    //   (  OpenGL)
+    IndirectRenderer(const IndirectRenderer&) = delete;
+    IndirectRenderer& operator=(const IndirectRenderer&) = delete;
+
+    //   :    (  )
+    void beginFrame();
+
+    /**
+     * @brief    .       .
+     * @param model   (16 float,  ).
+     * @param texture   (nullptr -  ).
+     */
+    void addObject(const Mesh& mesh, const Texture* texture, const float* model, int materialIndex, int culledLights);
+
+    /**
+     * @brief        GPU.
+     * @param cullShader   cull.comp.
+     * @param frustum    .
+     */
+    void cull(Shader& cullShader, const Frustum& frustum);
+
+    /**
+     * @brief    ,  cull() (  ).
+     * @param drawShader  indirect.vert + uber.frag ( drawBase).
+     */
+    void draw(const Shader& drawShader);
+
+    //     (       )
+    void clearGeometry();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    //   (std430,   ObjectEntry  cull.comp  indirect.vert)
+    struct ObjectRecord {
+        float model[16];
+        float boundingSphere[4];
+        uint32_t meshIndex;
+        int32_t materialIndex;
+        int32_t culledLights;
+        uint32_t pad;
+    };
+    static_assert(sizeof(ObjectRecord) == 96, "ObjectRecord must match the std430 ObjectEntry layout");
+
+    //      (std430, MeshEntry  cull.comp)
+    struct MeshRecord {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        int32_t baseVertex;
+        uint32_t pad;
+    };
+
+    //  glMultiDrawElementsIndirect (  OpenGL)
+    struct DrawElementsIndirectCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance;
+    };
+
+    //       -  
+    struct Batch {
+        const Texture* texture;
+        GLsizei first;
+        GLsizei count;
+    };
+
+    GLuint vertexArray = 0;
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0;
+    GLuint objectBuffer = 0;
+    GLuint meshBuffer = 0;
+    GLuint commandBuffer = 0;
+
+    //         
+    std::vector<const Mesh*> meshes;
+    std::unordered_map<const Mesh*, uint32_t> meshIndices;
+    std::vector<MeshRecord> meshRecords;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    bool geometryDirty = false;
+
+    std::vector<ObjectRecord> objects;
+    std::vector<Batch> batches;
+
+    //    GPU (    )
+    GLsizeiptr commandCapacity = 0;
+
+    Stats stats;
+
+    //      (    )
+    uint32_t acquireMesh(const Mesh& mesh);
+
+    //  ,      
+    void uploadGeometry();
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Camera.h"
+#include "Light/Light.h"
+
+/**
+ * @brief   :       .
+ *
+ *     GRID_X x GRID_Y    GRID_Z  
+ * (:   ).      
+ *   ,     ,     
+ *   (  CLUSTERED_LIGHTING).   
+ *      ,      .
+ *
+ *   - ,      ATTENUATION_CUTOFF.
+ *    CPU:     AABB  (  )
+ *  4    (SSE),   -       .
+ *
+ *  GPU (GL 3.3,  SSBO)     :
+ *  - LIGHTS_UNIT:  TEXELS_PER_LIGHT x RGBA32F   (. LightClusters.cpp);
+ *  - RANGES_UNIT:  RG32UI   -     ;
+ *  - INDICES_UNIT: R32UI -    .
+ *      -  uniform- ClusterData (CLUSTER_BLOCK_BINDING).
+ */
+class LightClusters {
+public:
+    static constexpr int GRID_X = 16;   //  4:    SSE  
+    static constexpr int GRID_Y = 9;
+    static constexpr int GRID_Z = 24;
+    static constexpr int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+    static constexpr int TEXELS_PER_LIGHT = 4;
+    static constexpr float ATTENUATION_CUTOFF = 1.0f / 256.0f;
+
+    //    (  LightingLUT)
+    static constexpr unsigned int LIGHTS_UNIT = 3;
+    static constexpr unsigned int RANGES_UNIT = 4;
+    static constexpr unsigned int INDICES_UNIT = 5;
+
+    struct Stats {
+        size_t pointLights = 0;
+        size_t spotLights = 0;
+        size_t references = 0;       //    
+        size_t maxPerCluster = 0;
+        size_t occupiedClusters = 0; //      
+        float buildMs = 0.0f;
+    };
+
+    /**
+     * @brief    .    OpenGL.
+     */
+    LightClusters();
+    ~LightClusters();
+
+    //   (  OpenGL)
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+
+    /**
+     * @brief         GPU.
+     *        .
+     * @param camera   ( ,  ,  ).
+     * @param viewMatrix   .
+     * @param lights  ;   (  LightData).
+     * @param viewportWidth, viewportHeight   ,    
+     * (     , . gl_FragCoord  ).
+     */
+    void build(const Camera& camera, const float* viewMatrix, const std::vector<std::shared_ptr<Light>>& lights,
+               int viewportWidth, int viewportHeight);
+
+    /**
+     * @brief      (0 -  ).
+     *   (   ) :   .
+     */
+    void setMaxLightsPerCluster(size_t count) { maxLightsPerCluster = count; }
+    size_t getMaxLightsPerCluster() const { return maxLightsPerCluster; }
+
+    //      
+    void bind() const;
+
+    const Stats& getStats() const { return stats; }
+
+    /**
+     * @brief ,       ATTENUATION_CUTOFF.
+     *   (linear = quadratic = 0) - .
+     */
+    static float lightRange(const Vec3& color, float constant, float linear, float quadratic);
+
+    //     ( )
+    static const char* instructionSet();
+
+private:
+    // ---   ClusterData (std140) ---
+    struct ClusterBlock {
+        uint32_t grid[4];      // GRID_X, GRID_Y, GRID_Z, 0
+        float tileSize[4];     //     (xy)
+        float depthSlice[4];   // near, far, scale, bias:  = log() * scale + bias
+    };
+
+    // ,    ( )
+    struct BinnedLight {
+        float center[3];       //   
+        float radius;
+        bool spot;
+        float apex[3];         //  : , ,     
+        float axis[3];
+        float range;
+        float cosAngle, sinAngle;
+    };
+
+    GLuint lightBuffer = 0, rangeBuffer = 0, indexBuffer = 0;
+    GLuint lightTexture = 0, rangeTexture = 0, indexTexture = 0;
+    GLuint uniformBuffer = 0;
+
+    //  ,     
+    float boundsFov = -1.0f, boundsAspect = -1.0f, boundsNear = -1.0f, boundsFar = -1.0f;
+
+    // GL_MAX_TEXTURE_BUFFER_SIZE:     
+    size_t maxReferences = 0;
+    bool overflowReported = false;
+
+    //     (0 -  )
+    size_t maxLightsPerCluster = 0;
+
+    //      ( ,  = (z * GRID_Y + y) * GRID_X + x)
+    std::vector<float> boundsMinX, boundsMinY, boundsMinZ;
+    std::vector<float> boundsMaxX, boundsMaxY, boundsMaxZ;
+    std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+
+    //  
+    std::vector<BinnedLight> binned;
+    std::vector<float> lightTexels;
+    std::vector<uint32_t> referenceCluster;   //  (, )   
+    std::vector<uint32_t> referenceLight;
+    std::vector<uint32_t> ranges;             // 2  : , 
+    std::vector<uint32_t> indices;
+
+    Stats stats;
+
+    //  AABB      
+    void updateClusterBounds(const Camera& camera);
+
+    //   (, )   ,   
+    void binLight(const BinnedLight& light, uint32_t lightIndex);
+
+    //     ClusterData
+    void upload(const Camera& camera, int viewportWidth, int viewportHeight);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Texture.h"
+
+/**
+ * @brief   (LUT)   ,   CPU  .
+ *
+ *        ,     
+ *     :
+ *  -   Oren-Nayar  (cos(theta_i), cos(theta_r)) -   normalize,
+ *     length    custom.frag / uber.frag;
+ *  -  toon-    -     toon.frag.
+ *       :    toonRampPath ( R,
+ *     - ,  - ).        .
+ *
+ *       ( 0   ).
+ */
+class LightingLUT {
+public:
+    static constexpr unsigned int OREN_NAYAR_UNIT = 1;
+    static constexpr unsigned int TOON_RAMP_UNIT = 2;
+
+    //   Oren-Nayar ()     
+    static constexpr int OREN_NAYAR_SIZE = 128;
+    static constexpr int TOON_RAMP_SIZE = 256;
+
+    //     (     - )
+    static constexpr float OREN_NAYAR_MAX = 4.0f;
+
+    /**
+     * @brief .       OpenGL (  ).
+     * @param toonRampPath  ;      -   .
+     */
+    explicit LightingLUT(const std::string& toonRampPath = "");
+
+    //   (  OpenGL)
+    LightingLUT(const LightingLUT&) = delete;
+    LightingLUT& operator=(const LightingLUT&) = delete;
+
+    //      
+    void bind() const;
+
+    /**
+     * @brief    Oren-Nayar.
+     *  (u, v)  max(0, cos_i) * sin(alpha) * tan(alpha) / (sin(theta_i) * sin(theta_r)),
+     *  u = cos_i, v = cos_r * 0.5 + 0.5.     
+     * (dot(L, V) - cos_i * cos_r) = cos(phi) * sin(theta_i) * sin(theta_r).
+     * @param size     .
+     * @return size * size    (v     ).
+     */
+    static std::vector<float> bakeOrenNayar(int size);
+
+    /**
+     * @brief   :  -  ,   
+     * (  ,     ),     quantize().
+     * @param levels   .
+     * @param size    .
+     */
+    static std::vector<float> bakeToonRamp(const std::vector<float>& levels, int size);
+
+private:
+    std::unique_ptr<Texture> orenNayarTexture;
+    std::unique_ptr<Texture> toonRampTexture;
+
+    //    ; false,       
+    bool loadToonRamp(const std::string& path);
+};
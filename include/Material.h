@@ -63,4 +63,10 @@ public:
 
     //  
     const Texture& getTexture() const { return *texture; }
+
+    //      (     )
+    bool hasTexture() const { return texture != nullptr; }
+
+    //      ( specular -    )
+    bool hasSpecular() const { return specular.x > 0.0f || specular.y > 0.0f || specular.z > 0.0f; }
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <unordered_map>
+#include <vector>
+#include "Material.h"
+#include "Shader.h"
+
+/**
+ * @brief        GPU.
+ *
+ *     uniform- ( MaterialData, std140),
+ *   MATERIAL_BLOCK_BINDING.     
+ *  (uniform materialIndex     ), 
+ *         ambient/diffuse/specular/shininess.
+ *
+ *  Material   ,  sync()    
+ *    GPU   .
+ */
+class MaterialTable {
+public:
+    // ---   (struct MaterialEntry  , std140) ---
+    struct EntryBlock {
+        float ambient[3];
+        float shininess;
+        float diffuse[3];
+        int lightingModel;
+        float specular[3];
+        int textured;
+    };
+
+    //  
+    struct Stats {
+        size_t uploads = 0;         //  glBufferSubData
+        size_t uploadedEntries = 0; //   
+    };
+
+    /**
+     * @brief .    MAX_MATERIALS    .
+     *    OpenGL.
+     */
+    MaterialTable();
+    ~MaterialTable();
+
+    //   (  OpenGL)
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    /**
+     * @brief   ,       .
+     *   ,    (   ).
+     * @return    -1,   .
+     */
+    int registerMaterial(const Material& material);
+
+    //     (-1,   )
+    int indexOf(const Material& material) const;
+
+    //   GPU ,    
+    void sync();
+
+    size_t size() const { return materials.size(); }
+    const Stats& getStats() const { return stats; }
+
+private:
+    GLuint bufferID = 0;
+
+    std::vector<const Material*> materials;
+    std::unordered_map<const Material*, int> indices;
+
+    //    (  ,   materials)
+    std::vector<EntryBlock> uploaded;
+    // ,     ,    
+    size_t uploadedCount = 0;
+
+    Stats stats;
+
+    static EntryBlock makeEntry(const Material& material);
+};
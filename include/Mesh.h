@@ -17,7 +17,15 @@ struct Vertex {
     Vec2 texCoords; //   (u, v)
 };
 
-// --- 2.  Mesh ---
+// --- 2.    (  ) ---
+struct MeshBounds {
+    Vec3 min;       //  AABB
+    Vec3 max;
+    Vec3 center;    //    ( AABB)
+    float radius;   //  :     
+};
+
+// --- 3.  Mesh ---
 
 class Mesh {
 public:
@@ -27,9 +35,10 @@ public:
 
     // ---  ---
 
-    //   MeshParser   
+    //   MeshParser    (   )
     Mesh(const std::vector<Vertex>& vertices,
-        const std::vector<unsigned int>& indices);
+        const std::vector<unsigned int>& indices,
+        const MeshBounds& bounds);
 
     //   (..   OpenGL)
     Mesh(const Mesh&) = delete;
@@ -50,10 +59,21 @@ public:
     //  
     void draw() const;
 
+    //       (gl_InstanceID = 0..instanceCount-1)
+    void drawInstanced(int instanceCount) const;
+
+    //  VAO (     )
+    unsigned int getVAO() const { return VAO; }
+
+    //  AABB    (    )
+    const MeshBounds& getBounds() const { return bounds; }
+
 private:
     // --- OpenGL  ---
     unsigned int VAO, VBO, EBO; // Vertex Array Object, Vertex Buffer Object, Element Buffer Object
 
+    MeshBounds bounds;
+
     // ---   ---
 
     //  
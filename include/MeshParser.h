@@ -41,6 +41,13 @@ public:
         bool operator<(const FaceIndex& other) const;
     };
 
+    /**
+     * @brief  AABB     .
+     * @param vertices   ( ).
+     * @return MeshBounds     .
+     */
+    static MeshBounds computeBounds(const std::vector<Vertex>& vertices);
+
     //       
     static std::vector<std::string> split(const std::string& s, char delimiter);
 };
\ No newline at end of file
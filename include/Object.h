@@ -2,6 +2,7 @@
 
 #include "Mesh.h"
 #include "Material.h"
+#include "SpatialIndex.h"
 #include <memory>
 #include <SFML/System/Vector3.hpp>
 
@@ -11,6 +12,8 @@ using Vec3 = sf::Vector3f;
 /**
  * @brief   3D-  .
  *   (Mesh),   (Material)  .
+ *    : Scene       (RenderQueue)
+ *   .
  */
 class Object {
 public:
@@ -41,12 +44,38 @@ public:
     // ,      float[16]
     void getModelMatrix(float modelMatrix[16]) const;
 
-    //  
-    void draw(const class Shader& shader) const;
-
     //     
     const Material& getMaterial() const { return *material; }
 
+    //        (   )
+    bool isDrawable() const { return mesh && material; }
+
+    //   (    )
+    const Mesh& getMesh() const { return *mesh; }
+
+    //    
+    const float* getModelMatrixData() const { return modelMatrix; }
+
+    /**
+     * @brief      .
+     *    ,       .
+     */
+    void getWorldBoundingSphere(Vec3& center, float& radius) const;
+
+    // AABB     (  -    )
+    void getWorldBounds(AABB& bounds) const;
+
+    /**
+     * @brief      .
+     *        (SpatialIndex::move).
+     */
+    void setSpatialProxy(SpatialIndex* index, int proxy);
+    int getSpatialProxy() const { return spatialProxy; }
+
+    // :    CPU      (. OcclusionRasterizer)
+    void setOccluder(bool enabled) { occluder = enabled; }
+    bool isOccluder() const { return occluder; }
+
     // ---   ---
     void setPosition(const Vec3& newPos);
     void setRotation(const Vec3& newRot);
@@ -61,6 +90,12 @@ private:
     //   (Model Matrix: Translation * Rotation * Scale)
     float modelMatrix[16];
 
+    //      (nullptr / -1 -    )
+    SpatialIndex* spatialIndex = nullptr;
+    int spatialProxy = -1;
+
+    bool occluder = false;
+
     //      
     void createIdentityMatrix(float matrix[16]);
 };
\ No newline at end of file
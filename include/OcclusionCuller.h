@@ -0,0 +1,100 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Mesh.h"
+#include "SpatialIndex.h"
+
+class Shader;
+
+/**
+ * @brief      (GL_ANY_SAMPLES_PASSED).
+ *
+ *     AABB (-,     )  .
+ *           
+ * (GL_QUERY_RESULT_AVAILABLE),  CPU    GPU.
+ *
+ *     :     ,
+ *     .    , 
+ *   .
+ *
+ *       glBeginConditionalRender:  GPU 
+ *   ,      .
+ */
+class OcclusionCuller {
+public:
+    //    ( :    )
+    struct ObjectStats {
+        uint32_t tested = 0;     //  
+        uint32_t occluded = 0;   //   - 
+    };
+
+    struct Stats {
+        size_t queriesIssued = 0;
+        size_t resultsRead = 0;
+        size_t resultsPending = 0;   //      
+        size_t occluded = 0;         // ,    
+    };
+
+    //    OpenGL (  -)
+    OcclusionCuller();
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    //    (   )
+    void resize(size_t objectCount);
+
+    //  :       
+    void beginFrame();
+
+    //  :        
+    void endFrame();
+
+    //        
+    bool wasVisible(size_t object) const { return records[object].visible; }
+
+    // ,      ( glBeginConditionalRender)
+    GLuint currentQuery(size_t object) const { return records[object].queries[frameSlot]; }
+
+    // -:     ,   
+    void beginProxyPass(const Shader& proxyShader);
+    void endProxyPass();
+
+    /**
+     * @brief  AABB       ( begin/endProxyPass).
+     * @param bounds  AABB  (  ,     ).
+     */
+    void issueQuery(size_t object, const AABB& bounds);
+
+    //     (,    AABB)
+    void markVisible(size_t object);
+
+    const Stats& getStats() const { return stats; }
+    const std::vector<ObjectStats>& getObjectStats() const { return objectStats; }
+
+    //  ,    
+    void printObjectStats(size_t maxObjects) const;
+
+private:
+    struct Record {
+        GLuint queries[2] = { 0, 0 };
+        bool issued[2] = { false, false };
+        bool visible = true;
+    };
+
+    std::vector<Record> records;
+    std::vector<ObjectStats> objectStats;
+    int frameSlot = 0;
+
+    std::unique_ptr<Mesh> proxyMesh;
+    const Shader* proxyShader = nullptr;
+
+    Stats stats;
+
+    void releaseQueries();
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpatialIndex.h"
+
+class Mesh;
+
+/**
+ * @brief    :    CPU.
+ *
+ *   (Object::setOccluder)     
+ * ,   AABB        .
+ *           GPU.
+ *
+ *     TILE_WIDTH x TILE_HEIGHT.    ,
+ *         ( );  
+ *   ,      .
+ *    4 (SSE),  SSE -  .
+ *
+ *    BLOCK_SIZE x BLOCK_SIZE   ()  -
+ *  Z: ,   ,  AABB,    .
+ *  - z/w  NDC (   ),   1.
+ */
+class OcclusionRasterizer {
+public:
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 128;
+    static constexpr int TILE_WIDTH = 64;
+    static constexpr int TILE_HEIGHT = 32;
+    static constexpr int BLOCK_SIZE = 8;
+
+    struct Stats {
+        size_t occluderTriangles = 0;   //      
+        size_t tested = 0;
+        size_t occluded = 0;
+        float rasterizeMs = 0.0f;
+    };
+
+    OcclusionRasterizer();
+    ~OcclusionRasterizer();
+
+    OcclusionRasterizer(const OcclusionRasterizer&) = delete;
+    OcclusionRasterizer& operator=(const OcclusionRasterizer&) = delete;
+
+    /**
+     * @brief  :    .
+     * @param viewProjection  projection * view  .
+     */
+    void beginFrame(const float viewProjection[16]);
+
+    //   ,    (  rasterize)
+    void addOccluder(const Mesh& mesh, const float modelMatrix[16]);
+
+    //         Z
+    void rasterize();
+
+    /**
+     * @brief   AABB   .
+     * @return true -  ,    AABB,    .
+     * AABB,   ,   .
+     */
+    bool isOccluded(const AABB& bounds);
+
+    const Stats& getStats() const { return stats; }
+
+    //   + 
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+    //     ( )
+    static const char* instructionSet();
+
+private:
+    static constexpr int TILES_X = WIDTH / TILE_WIDTH;
+    static constexpr int TILES_Y = HEIGHT / TILE_HEIGHT;
+    static constexpr int TILE_COUNT = TILES_X * TILES_Y;
+    static constexpr int BLOCKS_X = WIDTH / BLOCK_SIZE;
+    static constexpr int BLOCKS_Y = HEIGHT / BLOCK_SIZE;
+    static constexpr unsigned MAX_WORKERS = 3;
+
+    //   : E_i(x, y) = a*x + b*y + c >= 0 , z = za*x + zb*y + zc
+    struct Triangle {
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float zA, zB, zC;
+        int minX, maxX, minY, maxY;   // ,     
+    };
+
+    struct ClipVertex {
+        float x, y, z, w;
+    };
+
+    float viewProjection[16];
+
+    std::vector<float> depth;         // WIDTH x HEIGHT,   
+    std::vector<float> blockMaxDepth; // BLOCKS_X x BLOCKS_Y
+
+    std::vector<Triangle> triangles;
+    std::vector<uint32_t> tileBins[TILE_COUNT];
+    std::vector<ClipVertex> clipVertices; //   addOccluder
+
+    Stats stats;
+
+    // ---   ---
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation = 0;      //  ;     
+    unsigned busyWorkers = 0;
+    bool stopping = false;
+    std::atomic<int> nextTile{ 0 };
+
+    void workerLoop();
+
+    //    ,    
+    void processTiles();
+
+    //  ,        Z
+    void rasterizeTile(int tile);
+
+    //     (z >= -w)    
+    void clipAndAddTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+
+    //         
+    void setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+};
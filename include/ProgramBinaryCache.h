@@ -0,0 +1,71 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief  ( )    .
+ *  glGetProgramBinary / glProgramBinary (ARB_get_program_binary),
+ *         .
+ *
+ *   -  ,  #define   
+ * (GL_VENDOR / GL_RENDERER / GL_VERSION),   
+ *       .
+ */
+class ProgramBinaryCache {
+public:
+    //      
+    struct Stats {
+        size_t hits = 0;      //    
+        size_t misses = 0;    //   -    
+        size_t rejected = 0;  //    
+        size_t stored = 0;    //     
+    };
+
+    /**
+     * @brief .    OpenGL.
+     * @param directory     .
+     */
+    explicit ProgramBinaryCache(const std::string& directory = "shader_cache");
+
+    //  
+    ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+    ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+    //      
+    bool isSupported() const { return supported; }
+
+    /**
+     * @brief   .
+     * @param sources     .
+     * @param defines  #define,    .
+     * @return   .
+     */
+    std::string makeKey(const std::vector<std::string>& sources, const std::string& defines = "") const;
+
+    /**
+     * @brief     .
+     * @param key ,   makeKey().
+     * @param program  ()  .
+     * @return true,       .
+     */
+    bool load(const std::string& key, GLuint program);
+
+    /**
+     * @brief     .
+     *      GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+     */
+    void store(const std::string& key, GLuint program);
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    std::string cacheDirectory;
+    std::string driverId;   // GL_VENDOR | GL_RENDERER | GL_VERSION
+    bool supported;
+    Stats stats;
+
+    //    
+    std::string entryPath(const std::string& key) const;
+};
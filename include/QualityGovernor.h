@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Scene.h"
+
+/**
+ * @brief  :  GPU-   .
+ *
+ *      GL_TIME_ELAPSED   (Scene::RenderStats::gpuFrameMs)
+ *    .   -   
+ * (Scene::setRenderScale):     , 
+ *     scale * sqrt( / ).
+ *
+ * :
+ *  -    OVER_BUDGET *      UNDER_BUDGET * ;
+ *  -    SETTLE_FRAMES     ( 
+ *       RenderGraph::TIMER_FRAMES,   );
+ *  -    MAX_SCALE_STEP_UP,  - MAX_SCALE_STEP_DOWN.
+ *
+ *    ,      SECONDARY_PATIENCE  ,
+ *   :  (MSAA 8x -> 4x -> 2x -> FXAA -> ),
+ *     .        :
+ *  ,  .   ,  
+ *         (     ).
+ */
+class QualityGovernor {
+public:
+    static constexpr double DEFAULT_TARGET_MS = 1000.0 / 60.0;
+
+    static constexpr double OVER_BUDGET = 1.05;
+    static constexpr double UNDER_BUDGET = 0.80;
+    static constexpr double SMOOTHING = 0.2;          //      
+    static constexpr int SETTLE_FRAMES = 8;
+    static constexpr int SECONDARY_PATIENCE = 3;
+
+    static constexpr float MIN_SCALE = 0.5f;          //  -   (  Scene::MIN_RENDER_SCALE)
+    static constexpr float MAX_SCALE_STEP_DOWN = 0.25f;
+    static constexpr float MAX_SCALE_STEP_UP = 0.1f;
+
+    static constexpr size_t MIN_CLUSTER_LIGHTS = 4;   //       
+
+    explicit QualityGovernor(double targetMs = DEFAULT_TARGET_MS);
+
+    /**
+     * @brief          .
+     *       Scene::render.
+     */
+    void update(Scene& scene);
+
+    /**
+     * @brief   :  1       .
+     *     ,      .
+     */
+    void reset(Scene& scene);
+
+    //    
+    void setEnabled(bool enabled, Scene& scene);
+    bool isEnabled() const { return enabled; }
+
+    double getTargetMs() const { return targetMs; }
+    double getAverageMs() const { return averageMs; }
+
+private:
+    //       
+    struct SecondaryStep {
+        enum class Knob { ANTIALIASING, CLUSTER_LIGHTS } knob;
+        AntialiasingMode antialiasing;
+        size_t clusterLights;
+        double frameMsBefore;     //     
+        double savedMs;           //   (< 0 -   )
+    };
+
+    double targetMs;
+    bool enabled = true;
+
+    double averageMs = 0.0;       // 0 -    
+    int framesSinceChange = 0;
+    int overBudgetAtMinimum = 0;  //  :    
+    int underBudgetAtMaximum = 0; //  :       
+
+    //      (  )
+    std::vector<SecondaryStep> steps;
+
+    void setScale(Scene& scene, float scale);
+
+    //    ; false -  
+    bool stepDownSecondary(Scene& scene);
+
+    //    
+    void stepUpSecondary(Scene& scene);
+
+    //      
+    void restartMeasurement();
+};
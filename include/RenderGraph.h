@@ -0,0 +1,231 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief  :   ,    ,   ,
+ *   ,           .
+ *
+ *     : reset(), importTarget(), addPass()   ,
+ *  compile()  execute().       addPass()
+ *   PassBuilder  ;     execute().
+ *
+ *  - :  ,     ,  
+ *         ,    .
+ *  - :       ,  ,
+ *        ;   .
+ *  -   (create)        .
+ *       :       ,   ,
+ *       . ,   , ,
+ *      -     ,      .
+ *  -         ;  
+ *      ( ,  )     .
+ *  -      GL_TIME_ELAPSED;  
+ *     TIMER_FRAMES ,  GPU    ( ).
+ */
+class RenderGraph {
+public:
+    //   (  ); -1 -  
+    using Resource = int;
+
+    //         
+    static constexpr size_t TIMER_FRAMES = 3;
+
+    //    (  :   )
+    struct TextureDesc {
+        int width = 0;
+        int height = 0;
+        GLenum internalFormat = GL_RGBA8;
+        int samples = 1;                  // > 1 - GL_TEXTURE_2D_MULTISAMPLE ( texelFetch   )
+
+        bool operator==(const TextureDesc& other) const {
+            return width == other.width && height == other.height && internalFormat == other.internalFormat
+                && samples == other.samples;
+        }
+    };
+
+    //    (   )
+    class PassBuilder {
+    public:
+        //   ;     
+        Resource create(const std::string& name, const TextureDesc& desc);
+
+        //      ( PassContext::bindTexture)
+        Resource read(Resource resource);
+
+        /**
+         * @brief     ( -   ,  - ).
+         * @param clear    ( - ,  - ).
+         */
+        Resource write(Resource resource, bool clear = false);
+
+        //     ,     clearColor (RGBA)
+        Resource write(Resource resource, const GLfloat clearColor[4]);
+
+        //   ,        (,   CPU)
+        void setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, size_t pass) : graph(graph), pass(pass) {}
+        RenderGraph& graph;
+        size_t pass;
+    };
+
+    //        
+    class PassContext {
+    public:
+        GLuint texture(Resource resource) const;
+
+        /**
+         * @brief      (    ).
+         * @param linear   (  );   -   (NEAREST).
+         *         texelFetch.
+         */
+        void bindTexture(Resource resource, unsigned int unit, bool linear = false) const;
+
+        //     (     gl_VertexID)
+        void drawFullscreen() const;
+
+    private:
+        friend class RenderGraph;
+        explicit PassContext(const RenderGraph& graph) : graph(graph) {}
+        const RenderGraph& graph;
+    };
+
+    using SetupFunction = std::function<void(PassBuilder&)>;
+    using ExecuteFunction = std::function<void(const PassContext&)>;
+
+    struct Stats {
+        size_t passes = 0;
+        size_t passesCulled = 0;
+        size_t transientResources = 0;
+        size_t textures = 0;              //    
+        size_t transientBytes = 0;        //      
+        size_t allocatedBytes = 0;        //   
+    };
+
+    //  GPU-  ( ,    )
+    struct PassTime {
+        std::string name;
+        double milliseconds = 0.0;
+    };
+
+    RenderGraph();
+    ~RenderGraph();
+
+    //   (  OpenGL)
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    //   :      ,   
+    void reset();
+
+    /**
+     * @brief    (    FBO)   .
+     *      .
+     */
+    Resource importTarget();
+
+    /**
+     * @brief   ,     (   gl_FragCoord).
+     * @param scale < 1 -         (   
+     *   ,      ).
+     */
+    TextureDesc targetSizedDesc(GLenum internalFormat, int samples = 1, float scale = 1.0f) const;
+
+    //     (x, y, , )
+    const GLint* getTargetViewport() const { return targetViewport; }
+
+    // ,      (     )
+    const GLfloat* getTargetClearColor() const { return targetClearColor; }
+
+    //  ; setup  
+    void addPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute);
+
+    //   ,          
+    void compile();
+
+    //         
+    void execute();
+
+    const Stats& getStats() const { return stats; }
+
+    //     GPU    (,     )
+    const std::vector<PassTime>& getPassTimes() const { return passTimes; }
+
+private:
+    struct ResourceNode {
+        std::string name;
+        TextureDesc desc;
+        bool imported = false;
+        int firstPass = -1, lastPass = -1;
+        int texture = -1;            //   pool
+    };
+
+    struct PassNode {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<Resource> reads;
+        std::vector<Resource> colorWrites;
+        Resource depthWrite = -1;
+        std::vector<Resource> clears;
+        std::vector<std::array<GLfloat, 4>> clearColors; //     clears (   )
+        bool sideEffect = false;
+        bool writesTarget = false;
+        bool live = false;
+    };
+
+    struct PooledTexture {
+        GLuint id = 0;
+        TextureDesc desc;
+        bool used = false;           //   
+        int busyUntil = -1;          //     (-1 -    )
+    };
+
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    std::vector<PooledTexture> pool;
+
+    //      (  ,  )
+    std::map<std::vector<GLuint>, GLuint> framebuffers;
+
+    GLint targetFramebuffer = 0;
+    GLint targetViewport[4] = { 0, 0, 0, 0 };
+    GLfloat targetClearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    GLuint emptyVertexArray = 0;
+
+    //    PassContext::bindTexture(..., linear = true)
+    GLuint linearSampler = 0;
+
+    //   :   TIMER_FRAMES ,   -    
+    std::vector<std::pair<std::string, GLuint>> timerFrames[TIMER_FRAMES];
+    std::vector<GLuint> freeTimerQueries;
+    size_t timerFrame = 0;
+    std::vector<PassTime> passTimes;
+
+    Stats stats;
+
+    //    ,    TIMER_FRAMES  
+    void collectPassTimes(std::vector<std::pair<std::string, GLuint>>& frame);
+
+    //     ,    firstPass  lastPass
+    int acquireTexture(const TextureDesc& desc, int firstPass, int lastPass);
+
+    //      (   )
+    GLuint framebufferFor(const PassNode& pass);
+
+    //   ,   
+    void forgetFramebuffers(GLuint texture);
+
+    static GLenum textureTarget(const TextureDesc& desc);
+    static bool isDepthFormat(GLenum internalFormat);
+    static size_t bytesPerTexel(GLenum internalFormat);
+};
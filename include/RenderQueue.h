@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Shader;
+class Mesh;
+class Texture;
+
+/**
+ * @brief   (   ).
+ */
+enum class RenderPass : uint8_t {
+    OPAQUE_GEOMETRY = 0,  //  ,     
+    OCCLUSION_TESTED = 1  // ,    :   -,  
+};
+
+/**
+ * @brief  : ,     ,     .
+ */
+struct DrawCommand {
+    const Shader* shader;
+    const Mesh* mesh;
+    const Texture* texture;   // nullptr -  
+    const float* model;       //   (16 float,  )
+    int materialIndex;        //   MaterialTable
+    int culledLights;         //   LightData,    (. Scene::cullObjectLights)
+    unsigned int occlusionQuery;  //   glBeginConditionalRender (0 -  )
+};
+
+/**
+ * @brief    64-  .
+ *
+ *   (submit)      OpenGL:  sort()  
+ *    ,          .
+ *
+ *   (    ):
+ *   [63..60]  | [59..48]  | [47..36]  | [35..24]  | [23..0] 
+ *       ,    ()  ,
+ *            .
+ *       :     
+ * ,     .
+ */
+class RenderQueue {
+public:
+    static constexpr int PASS_BITS = 4;
+    static constexpr int PROGRAM_BITS = 12;
+    static constexpr int MATERIAL_BITS = 12;
+    static constexpr int MESH_BITS = 12;
+    static constexpr int DEPTH_BITS = 24;
+    static_assert(PASS_BITS + PROGRAM_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64, "Sort key must fill 64 bits");
+
+    struct Stats {
+        size_t commands = 0;
+        int radixPasses = 0;   //    (     )
+    };
+
+    static uint64_t makeKey(RenderPass pass, uint32_t program, uint32_t material, uint32_t mesh, uint32_t depth);
+
+    /**
+     * @brief        .
+     * @param viewDepth    .
+     * @param nearPlane   .
+     * @param farPlane   .
+     */
+    static uint32_t quantizeDepth(float viewDepth, float nearPlane, float farPlane);
+
+    //       (  )
+    void clear();
+
+    void submit(uint64_t key, const DrawCommand& command);
+
+    //     ( , LSD  )
+    void sort();
+
+    //     ( sort())
+    const std::vector<DrawCommand>& getCommands() const { return sorted; }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t command;
+    };
+
+    std::vector<DrawCommand> commands;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+    std::vector<DrawCommand> sorted;
+
+    Stats stats;
+};
@@ -10,11 +10,80 @@
 #include "Object.h"
 #include "Camera.h"
 #include "ShaderManager.h"
+#include "AssetRegistry.h"
+#include "LightingLUT.h"
+#include "FrameUniforms.h"
+#include "MaterialTable.h"
+#include "StreamBuffer.h"
+#include "GLStateCache.h"
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "SpatialIndex.h"
+#include "OcclusionCuller.h"
+#include "OcclusionRasterizer.h"
+#include "LightClusters.h"
+#include "RenderGraph.h"
+#include "IndirectRenderer.h"
+#include "ImpostorAtlas.h"
 #include "Light/Light.h"
 #include "Light/PointLight.h"
 #include "Light/DirectionalLight.h"
 #include "Light/SpotLight.h"
 
+/**
+ * @brief   .
+ */
+enum class RenderMode {
+    PER_MODEL,   //   ( )    
+    UBERSHADER,  //  :   ,     
+    DEFERRED,    //  :    G-,     
+    GPU_DRIVEN   //     -  GPU,   -  glMultiDrawElementsIndirect
+};
+
+//    
+inline const char* renderModeName(RenderMode mode) {
+    switch (mode) {
+    case RenderMode::UBERSHADER: return "UBERSHADER";
+    case RenderMode::DEFERRED: return "DEFERRED";
+    case RenderMode::GPU_DRIVEN: return "GPU_DRIVEN";
+    default: return "PER_MODEL";
+    }
+}
+
+/**
+ * @brief   (. Scene::setAntialiasing).
+ *  :       ,  
+ *     - FXAA       MSAA.
+ */
+enum class AntialiasingMode {
+    NONE,      //      
+    FXAA,      //    (  )
+    MSAA_2X,   //    ,     
+    MSAA_4X,
+    MSAA_8X
+};
+
+//     
+inline const char* antialiasingModeName(AntialiasingMode mode) {
+    switch (mode) {
+    case AntialiasingMode::FXAA: return "FXAA";
+    case AntialiasingMode::MSAA_2X: return "MSAA 2x";
+    case AntialiasingMode::MSAA_4X: return "MSAA 4x";
+    case AntialiasingMode::MSAA_8X: return "MSAA 8x";
+    default: return "no AA";
+    }
+}
+
+//       (1 - )
+inline int antialiasingSamples(AntialiasingMode mode) {
+    switch (mode) {
+    case AntialiasingMode::MSAA_2X: return 2;
+    case AntialiasingMode::MSAA_4X: return 4;
+    case AntialiasingMode::MSAA_8X: return 8;
+    default: return 1;
+    }
+}
+
 /**
  * @brief   ,  ,    .
  */
@@ -23,8 +92,9 @@ public:
     /**
      * @brief  .
      * @param shaderMgr   ShaderManager    .
+     * @param registry     ,   .
      */
-    Scene(ShaderManager& shaderMgr);
+    Scene(ShaderManager& shaderMgr, AssetRegistry& registry);
 
     //   :  ,   
     void setupScene();
@@ -38,6 +108,116 @@ public:
      */
     void render(const Camera& camera);
 
+    // ---   ---
+
+    //    (  )
+    struct RenderStats {
+        size_t drawCalls = 0;
+        size_t programSwitches = 0;
+        size_t stateChangesIssued = 0;   //   ,   (GLStateCache)
+        size_t stateChangesSkipped = 0;  // ,   
+        size_t objectsCulled = 0;        //     (GPU_DRIVEN:  GPU,  0)
+        size_t indirectCommands = 0;     //    GPU_DRIVEN (   ,  )
+        size_t objectsOccluded = 0;      //     (    )
+        size_t occlusionQueries = 0;
+        size_t objectsRasterOccluded = 0; //    CPU (  )
+        size_t clusterLightReferences = 0; //    (0 -    )
+        size_t maxLightsPerCluster = 0;
+        size_t objectLightsCulled = 0;   //  ( ,  LightData),  
+        size_t impostors = 0;            // ,   (   )
+        size_t renderPasses = 0;         //    
+        size_t renderTargetBytes = 0;    //    ( )
+        size_t renderTargetBytesUnaliased = 0; //   ,        
+        double gpuFrameMs = 0.0;         // GPU-   ( RenderGraph::TIMER_FRAMES  )
+        double gpuAntialiasingMs = 0.0;  //   -  
+    };
+
+    /**
+     * @brief   .
+     * GPU_DRIVEN     (IndirectRenderer::isSupported)   UBERSHADER.
+     */
+    void setRenderMode(RenderMode mode);
+    RenderMode getRenderMode() const { return renderMode; }
+
+    const RenderStats& getRenderStats() const { return renderStats; }
+
+    /**
+     * @brief      .
+     *    ,    .
+     */
+    void setOcclusionCulling(bool enabled);
+    bool isOcclusionCullingEnabled() const { return occlusionCulling; }
+
+    /**
+     * @brief   :    CPU,
+     *         (   ).
+     */
+    void setSoftwareOcclusion(bool enabled);
+    bool isSoftwareOcclusionEnabled() const { return softwareOcclusion; }
+
+    /**
+     * @brief    .
+     *    ,      
+     * ,     LightData (MAX_POINT_LIGHTS, MAX_SPOT_LIGHTS).
+     */
+    void setClusteredLighting(bool enabled);
+    bool isClusteredLightingEnabled() const { return clusteredLighting; }
+
+    /**
+     * @brief   (   ).
+     *   MSAA    .   DEFERRED G-
+     * ,  MSAA        .
+     */
+    void setAntialiasing(AntialiasingMode mode);
+    AntialiasingMode getAntialiasing() const { return antialiasing; }
+
+    // ---    (. QualityGovernor) ---
+
+    //    
+    static constexpr float MIN_RENDER_SCALE = 0.25f;
+
+    /**
+     * @brief       (MIN_RENDER_SCALE..1,    ).
+     *    1         
+     *      (   ).
+     */
+    void setRenderScale(float scale);
+    float getRenderScale() const { return renderScale; }
+
+    //       (0 -  , . LightClusters)
+    void setMaxLightsPerCluster(size_t count);
+    size_t getMaxLightsPerCluster() const;
+
+    // ---    ( UBERSHADER  DEFERRED, . ImpostorAtlas) ---
+
+    //   :     ,   
+    static constexpr float DEFAULT_IMPOSTOR_THRESHOLD = 32.0f;
+
+    //    ->  ( ):    * (1 + FADE_BAND)  -  
+    static constexpr float IMPOSTOR_FADE_BAND = 0.25f;
+
+    /**
+     * @brief ,        (   ),
+     *      .     * (1 + IMPOSTOR_FADE_BAND)
+     *      ( ),  . 0 -  .
+     */
+    void setImpostorThreshold(float pixels);
+    float getImpostorThreshold() const { return impostorThreshold; }
+
+    // ---   ---
+
+    //  ;          
+    void addLight(std::shared_ptr<Light> light);
+
+    //     
+    static constexpr int LANTERNS_PER_RING = 8;
+
+    /**
+     * @brief   :       .
+     *     MAX_POINT_LIGHTS,      .
+     */
+    void addLanternRing();
+
     // ---   (SpotLight) ---
 
     /**
@@ -72,7 +252,26 @@ public:
      */
     void syncPointLightWithCamera(const Camera& camera);
 
+    // ---   ---
+
+    /**
+     * @brief ,  AABB    (,    ).
+     * @param result   (  ).
+     */
+    void queryObjectsInSphere(const Vec3& center, float radius, std::vector<uint32_t>& result) const;
+
+    /**
+     * @brief    (,    ).
+     * @param direction   .
+     * @return      AABB  -1.
+     */
+    int pickObject(const Vec3& origin, const Vec3& direction, float maxDistance) const;
+
 private:
+    // ---   (BVH   AABB ) ---
+    //   objects:        
+    SpatialIndex spatialIndex;
+
     // ---   ---
     std::vector<std::shared_ptr<Object>> objects;
     std::vector<std::shared_ptr<Light>> lights;
@@ -83,8 +282,131 @@ private:
     // ---      ---
     int activePointLightIndex = -1;
 
+    // ---    ---
+    static constexpr const char* TOON_RAMP_PATH = "src/res/textures/toon_ramp.png";
+    std::unique_ptr<LightingLUT> lightingLUT;
+
+    // --- Uniform-  (  ) ---
+    std::unique_ptr<FrameUniforms> frameUniforms;
+
+    // ---    GPU (   ) ---
+    std::unique_ptr<MaterialTable> materialTable;
+
+    //   materialTable   objects[i] (-1 -     )
+    std::vector<int> objectMaterialIndices;
+
+    // ---    ,      ---
+    //    ;       (. reserveInstanceBlocks)
+    static constexpr GLsizeiptr STREAM_FRAME_SIZE = 256 * 1024;
+    std::unique_ptr<StreamBuffer> streamBuffer;
+
+    // ---     ---
+    // BVH     ;    
+    //      (FrustumCuller)
+    FrustumCuller culler;
+    std::vector<uint32_t> insideObjects;
+    std::vector<uint32_t> boundaryObjects;
+    std::vector<uint8_t> boundaryVisible;
+
+    // 1 - objects[i]    
+    std::vector<uint8_t> objectVisible;
+
+    // ---    ( ) ---
+    std::unique_ptr<OcclusionCuller> occlusionCuller;
+    bool occlusionCulling = false;
+
+    //    :     (  )
+    //   ( ,     )
+    std::vector<uint32_t> occlusionTested;
+    std::vector<uint32_t> occlusionConfirmed;
+
+    // 1 - objects[i]  occlusionTested
+    std::vector<uint8_t> objectOcclusionTested;
+
+    // ---     (    CPU) ---
+    std::unique_ptr<OcclusionRasterizer> occlusionRasterizer;
+    bool softwareOcclusion = true;
+
+    // ---   (     ) ---
+    std::unique_ptr<LightClusters> lightClusters;
+    bool clusteredLighting = false;
+    int lanternRings = 0;   //    (. addLanternRing)
+
+    //    CLUSTERED_LIGHTING (. makeLightingKey)
+    bool clusteredFrame = false;
+
+    // ---     (    ) ---
+    //   LightData,    objects[i] (0 -   )
+    std::vector<int> objectCulledLights;
+    std::vector<uint32_t> lightObjects;
+
+    // ---   ( ,      ) ---
+    std::unique_ptr<RenderGraph> renderGraph;
+
+    //  G-  DEFERRED (     ).
+    //   texelFetch  gl_FragCoord, . gbuffer.frag  deferred.frag:
+    //  - POSITION: RGBA32F -         (w);
+    //  - NORMAL:   RGBA16F -       (w);
+    //  - ALBEDO:   RGBA8   -    (    );
+    //  - DEPTH:    DEPTH24 - ;    1 ()  .
+    static constexpr unsigned int GBUFFER_POSITION_UNIT = 6;
+    static constexpr unsigned int GBUFFER_NORMAL_UNIT = 7;
+    static constexpr unsigned int GBUFFER_ALBEDO_UNIT = 8;
+    static constexpr unsigned int GBUFFER_DEPTH_UNIT = 9;
+
+    // ---  (   ,     ) ---
+    AntialiasingMode antialiasing = AntialiasingMode::FXAA;
+
+    //    (MSAA   DEFERRED  )
+    AntialiasingMode frameAntialiasing = AntialiasingMode::NONE;
+
+    //      
+    static constexpr unsigned int SCENE_COLOR_UNIT = 10;
+
+    //      (       )
+    static constexpr const char* ANTIALIASING_PASS = "Antialiasing";
+
+    // --- ,  GPU ( GPU_DRIVEN;      ) ---
+    //     batchOrder,      
+    std::unique_ptr<IndirectRenderer> indirectRenderer;
+
+    // ---    (      ) ---
+    std::unique_ptr<ImpostorAtlas> impostorAtlas;
+    float impostorThreshold = DEFAULT_IMPOSTOR_THRESHOLD;
+
+    //    objects[i]: 0 -  , 1 -  ,   - 
+    std::vector<float> objectImpostorFade;
+
+    // ---   (      ) ---
+    float renderScale = 1.0f;
+
+    // ---    PER_MODEL (  ) ---
+    RenderQueue renderQueue;
+
+    // ---     ---
+    RenderMode renderMode = RenderMode::PER_MODEL;
+    RenderStats renderStats;
+
+    // ---   UBERSHADER ---
+
+    //     InstanceData (uber.vert, std140)
+    struct UberInstance {
+        float model[16];
+        int materialIndex;
+        int culledLights;
+        float impostorFade;
+        int pad;
+    };
+
+    //  ,     :     -  
+    std::vector<size_t> batchOrder;
+
+    //  ,      ( , . StreamBuffer::uploadOverflow)
+    std::vector<UberInstance> overflowInstances;
+
     // ---  ---
     ShaderManager& shaderManager;
+    AssetRegistry& assetRegistry;
 
     // ---    ---
 
@@ -95,8 +417,136 @@ private:
     void setupObjects();
 
     /**
-     * @brief        .
-     * @param shader  .
+     * @brief  uniform-       .
+     *     ;    .
+     */
+    void updateFrameUniforms(const Camera& camera, const float* viewMatrix, const float* projMatrix);
+
+    //  ,       ( )
+    void setProgramConstants(const Shader& shader);
+
+    //     ,     
+    void indexObjects();
+
+    /**
+     * @brief      (  BVH +     ).
+     *  - objectVisible;      .
+     * @return   .
+     */
+    size_t cullObjects(const Camera& camera);
+
+    /**
+     * @brief        ,  .
+     * @param viewProjection  projection * view .
+     * @return   .
+     */
+    size_t rasterizeOccluders(const float* viewProjection);
+
+    /**
+     * @brief        .
+     *   UBERSHADER  DEFERRED    (objectVisible = 0)   .
+     */
+    void classifyOcclusion(const Camera& camera);
+
+    /**
+     * @brief       LightData,     :
+     *      (LightClusters::lightRange)    .
+     *     -    BVH.     .
+     * @return    (, ).
+     */
+    size_t cullObjectLights();
+
+    //  -      
+    void issueOcclusionQueries(const std::vector<uint32_t>& objectIndices);
+
+    /**
+     * @brief           .
+     * @param camera   (    ).
+     * @param viewMatrix   .
+     */
+    void recordDrawCommands(const Camera& camera, const float* viewMatrix);
+
+    // 3.    
+    void renderPerModel();
+    void renderUber();
+
+    /**
+     * @brief       DEFERRED:   G-
+     * (  )       .
+     * @return   (. writeSceneTarget).
+     */
+    RenderGraph::Resource addDeferredPasses(RenderGraph::Resource target);
+
+    //   :    ,   renderScale
+    RenderGraph::TextureDesc sceneTargetDesc(GLenum internalFormat, int samples = 1) const;
+
+    /**
+     * @brief      :      -
+     *      (  MSAA,     ),
+     *  -    .
+     * @return   .
+     */
+    RenderGraph::Resource writeSceneTarget(RenderGraph::PassBuilder& builder, RenderGraph::Resource target);
+
+    /**
+     * @brief  : FXAA    MSAA      
+     * (   -      ).
+     * @return   .
+     */
+    RenderGraph::Resource addAntialiasingPass(RenderGraph::Resource sceneColor, RenderGraph::Resource target);
+
+    //          
+    void addUpscalePass(RenderGraph::Resource sceneColor, RenderGraph::Resource target);
+
+    /**
+     * @brief       .
+     * @param impostorShader nullptr -  (uber.vert:   G-),     1 ;
+     *  -       0   (impostor.vert),  -   (, ).
      */
-    void sendLightDataToShader(Shader& shader);
+    void drawInstanceBatches(const Shader* impostorShader = nullptr);
+
+    //   objects[index]    (impostors = false)   (impostors = true)
+    bool isInstanceDrawn(size_t index, bool impostors) const;
+
+    //   drawInstanceBatches:    InstanceData     
+    size_t countInstanceBatches(bool impostors) const;
+
+    //           ( beginFrame)
+    void reserveInstanceBlocks();
+
+    /**
+     * @brief  ,    (objectImpostorFade),    .
+     *   -    ;   PER_MODEL  GPU_DRIVEN   .
+     * @param projMatrix    (   - projMatrix[5]).
+     * @return    .
+     */
+    size_t selectImpostors(const Camera& camera, const float* projMatrix);
+
+    //    (  ):   (impostor.vert + uber.frag)   G- (gbuffer.frag)
+    void drawImpostors(bool geometryPass);
+
+    /**
+     * @brief       GPU_DRIVEN:    (  batchOrder)
+     *   GPU,     .
+     * @param frustum    .
+     */
+    void addIndirectCullingPass(const Frustum& frustum);
+
+    //   ,   GPU (indirect.vert + uber.frag)
+    void renderIndirect();
+
+    //       (   )
+    void registerMaterials();
+
+    //     (   GPU_DRIVEN)
+    void buildUberBatches();
+
+    // 4.   
+
+    //   ,    :    
+    // (  ,       LightData)
+    ShaderVariantKey makeLightingKey() const;
+
+    //      ( , , )
+    ShaderVariantKey makeVariantKey(const Material& material, const ShaderVariantKey& lightingKey) const;
 };
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+#include <memory>
+#include <vector>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Vector3.hpp>
 
@@ -12,8 +15,152 @@
 using Vec2 = sf::Vector2f;
 using Vec3 = sf::Vector3f;
 
+//  4x4 (column-major),    Camera  Object
+using Mat4 = float[16];
+
+//  float  (,  ax + by + cz + d, . Frustum)
+using Vec4 = float[4];
+
+//     (   #define  .frag)
+constexpr int MAX_POINT_LIGHTS = 4;
+constexpr int MAX_SPOT_LIGHTS = 2;
+
+//     (   #define  uber.vert)
+constexpr int MAX_UBER_INSTANCES = 32;
+
+//    (   MAX_MATERIALS  .frag; 256 * 48  < 16  )
+constexpr int MAX_MATERIALS = 256;
+
+//   uniform-  (. FrameUniforms);     
+constexpr GLuint CAMERA_BLOCK_BINDING = 0;
+constexpr GLuint LIGHTS_BLOCK_BINDING = 1;
+constexpr GLuint MATERIAL_BLOCK_BINDING = 2;
+constexpr GLuint INSTANCE_BLOCK_BINDING = 3;
+constexpr GLuint CLUSTER_BLOCK_BINDING = 4;
+
+//      GPU_DRIVEN (. IndirectRenderer;   layout(binding)  indirect.vert  cull.comp)
+constexpr GLuint OBJECT_STORAGE_BINDING = 0;
+constexpr GLuint MESH_STORAGE_BINDING = 1;
+constexpr GLuint DRAW_COMMAND_STORAGE_BINDING = 2;
+
+/**
+ * @brief   uniform-.
+ *    location,        .
+ *  T ,    Shader::set()    .
+ */
+template <typename T>
+struct Uniform {
+    GLint location = -1;
+
+    // -   (separable) ; 0 -   (glUniform*)
+    GLuint program = 0;
+
+    constexpr Uniform() = default;
+    constexpr explicit Uniform(GLint loc, GLuint prog = 0) : location(loc), program(prog) {}
+
+    // -1 ,         
+    constexpr bool isValid() const { return location >= 0; }
+};
+
+// ---       ---
+
+//       GPU (. MaterialTable);    
+struct MaterialUniforms {
+    Uniform<int> index;
+    Uniform<int> textureDiffuse;
+};
+
+//    (. LightingLUT)
+struct LookupTableUniforms {
+    Uniform<int> orenNayar;
+    Uniform<int> toonRamp;
+};
+
+//     (. LightClusters;    CLUSTERED_LIGHTING)
+struct ClusterUniforms {
+    Uniform<int> lights;
+    Uniform<int> ranges;
+    Uniform<int> indices;
+};
+
+//  G- (. Scene::addDeferredPasses;     deferred.frag)
+struct GBufferUniforms {
+    Uniform<int> position;
+    Uniform<int> normal;
+    Uniform<int> albedo;
+    Uniform<int> depth;
+};
+
+//      (. Scene::addAntialiasingPass  Scene::addUpscalePass)
+struct PostProcessUniforms {
+    Uniform<int> sceneColor;
+    Uniform<int> sampleCount;    // msaa_resolve.frag
+    Uniform<Vec2> targetOrigin;  // upscale.frag:    
+    Uniform<Vec2> targetSize;
+};
+
+//     GPU_DRIVEN (. IndirectRenderer)
+struct IndirectDrawUniforms {
+    Uniform<Vec4> frustumPlanes;  // cull.comp:    
+    Uniform<int> objectCount;
+    Uniform<int> drawBase;        // indirect.vert:    glMultiDrawElementsIndirect
+};
+
+//    (. ImpostorAtlas)
+struct ImpostorUniforms {
+    Uniform<int> albedo;              // uber.frag / gbuffer.frag  #define IMPOSTOR:  
+    Uniform<int> normalDepth;
+    Uniform<Vec4> bounds;             // impostor.vert:     
+    Uniform<Mat4> bakeViewProjection; // impostor_bake.vert:   
+    Uniform<int> bakeTextured;        // impostor_bake.frag:     
+};
+
+/**
+ * @brief  uniform-,   phong.frag, toon.frag  custom.frag.
+ *      .
+ * ,        :    uniform-
+ * (. FrameUniforms  MaterialTable).
+ */
+struct StandardUniforms {
+    Uniform<Mat4> model;
+
+    //  LightData,     ( i - , MAX_POINT_LIGHTS + i - )
+    Uniform<int> culledLights;
+
+    MaterialUniforms material;
+
+    LookupTableUniforms lookupTables;
+
+    ClusterUniforms clusters;
+
+    GBufferUniforms gBuffer;
+
+    PostProcessUniforms postProcess;
+
+    IndirectDrawUniforms indirect;
+
+    ImpostorUniforms impostor;
+};
+
+/**
+ * @brief   (separable)  .
+ */
+enum class ShaderStage {
+    VERTEX,
+    FRAGMENT,
+    COMPUTE    //   ( ,  separable)
+};
+
 /**
  * @brief -    OpenGL.
+ *  :
+ *  -   ( +  );
+ *  -   (GL_PROGRAM_SEPARABLE),      ;
+ *  -      (ARB_separate_shader_objects);
+ *  -   (glDispatchCompute  use()).
+ *
+ *    :       ,
+ *      isReady() (   KHR_parallel_shader_compile).
  */
 class Shader {
 public:
@@ -24,18 +171,133 @@ public:
      * @brief ,     .
      * @param vertexPath      (.vert).
      * @param fragmentPath      (.frag).
+     * @param binaryCache    (nullptr -    ).
+     * @param defines  #define   (  #version).
+     * @param asynchronous     ( -  isReady() / finish()).
      */
-    Shader(const char* vertexPath, const char* fragmentPath);
+    Shader(const char* vertexPath, const char* fragmentPath, class ProgramBinaryCache* binaryCache = nullptr,
+           const std::string& defines = "", bool asynchronous = false);
+
+    /**
+     * @brief    (separable program)    (ShaderStage::COMPUTE).
+     * @param stage  .
+     * @param path    .
+     * @param binaryCache    (  nullptr).
+     * @param defines  #define   (  #version).
+     * @param asynchronous     ( -  isReady() / finish()).
+     */
+    Shader(ShaderStage stage, const char* path, class ProgramBinaryCache* binaryCache = nullptr,
+           const std::string& defines = "", bool asynchronous = false);
+
+    /**
+     * @brief       .
+     *      , use()   .
+     * @param pipeline    (  ).
+     * @param vertexStage   (     ).
+     * @param fragmentStage  .
+     */
+    Shader(GLuint pipeline, std::shared_ptr<Shader> vertexStage, std::shared_ptr<Shader> fragmentStage);
 
     // 
     ~Shader();
 
+    //   (..   OpenGL)
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     // ---   ---
 
     //   
     void use() const;
 
-    // ---   Uniforms ---
+    //        
+    bool isPipeline() const { return pipelineID != 0; }
+
+    //  ,         
+    // (   -  ,  ).    .
+    GLuint getStateID() const { return pipelineID != 0 ? fragmentStage->ID : ID; }
+
+    // ---   ---
+
+    /**
+     * @brief ,   ,    (GL_COMPLETION_STATUS_KHR).
+     *  KHR_parallel_shader_compile    (   ).
+     * @return true,      uniform- .
+     * @throws std::runtime_error       ( ).
+     */
+    bool isReady();
+
+    /**
+     * @brief    ().
+     * @throws std::runtime_error      .
+     */
+    void finish();
+
+    //   ;   
+    bool hasFailed() const { return failed; }
+
+    // ---  uniform- ---
+
+    /**
+     * @brief   uniform-   ( .. "pointLights[1].color").
+     *    ,   ;    .
+     * @return ; isValid() == false,     .
+     */
+    template <typename T>
+    Uniform<T> uniform(const std::string& name) const {
+        auto it = uniformSlots.find(name);
+        if (it == uniformSlots.end()) {
+            return Uniform<T>();
+        }
+        return Uniform<T>(it->second.location, it->second.program);
+    }
+
+    // Location      (-1,   )
+    GLint getUniformLocation(const std::string& name) const;
+
+    //        
+    const StandardUniforms& standardUniforms() const { return standard; }
+
+    // ---   (   ) ---
+
+    //     glProgramUniform*, .. glUniform*     
+    void set(Uniform<bool> u, bool value) const { set(Uniform<int>(u.location, u.program), (int)value); }
+    void set(Uniform<int> u, int value) const {
+        if (!u.isValid()) return;
+        if (u.program) glProgramUniform1i(u.program, u.location, value); else glUniform1i(u.location, value);
+    }
+    void set(Uniform<float> u, float value) const {
+        if (!u.isValid()) return;
+        if (u.program) glProgramUniform1f(u.program, u.location, value); else glUniform1f(u.location, value);
+    }
+    void set(Uniform<Vec2> u, const Vec2& value) const {
+        if (!u.isValid()) return;
+        if (u.program) glProgramUniform2f(u.program, u.location, value.x, value.y); else glUniform2f(u.location, value.x, value.y);
+    }
+    void set(Uniform<Vec3> u, const Vec3& value) const {
+        if (!u.isValid()) return;
+        if (u.program) glProgramUniform3f(u.program, u.location, value.x, value.y, value.z); else glUniform3f(u.location, value.x, value.y, value.z);
+    }
+    void set(Uniform<Mat4> u, const float* matrixData) const {
+        if (!u.isValid()) return;
+        if (u.program) glProgramUniformMatrix4fv(u.program, u.location, 1, GL_FALSE, matrixData); else glUniformMatrix4fv(u.location, 1, GL_FALSE, matrixData);
+    }
+
+    // :    ("name[0]")    
+    void setArray(Uniform<int> u, const int* values, int count) const {
+        if (!u.isValid() || count <= 0) return;
+        if (u.program) glProgramUniform1iv(u.program, u.location, count, values); else glUniform1iv(u.location, count, values);
+    }
+    void setArray(Uniform<Mat4> u, const float* matrices, int count) const {
+        if (!u.isValid() || count <= 0) return;
+        if (u.program) glProgramUniformMatrix4fv(u.program, u.location, count, GL_FALSE, matrices); else glUniformMatrix4fv(u.location, count, GL_FALSE, matrices);
+    }
+    void setArray(Uniform<Vec4> u, const float* vectors, int count) const {
+        if (!u.isValid() || count <= 0) return;
+        if (u.program) glProgramUniform4fv(u.program, u.location, count, vectors); else glUniform4fv(u.location, count, vectors);
+    }
+
+    // ---   Uniforms   ---
 
     // :
     void setBool(const std::string& name, bool value) const;
@@ -53,6 +315,67 @@ public:
     void setMat4(const std::string& name, const float* matrixData) const;
 
 private:
+    //  uniform-: location  - (0 - )
+    struct UniformSlot {
+        GLint location;
+        GLuint program;
+    };
+
+    //  " -> location"   uniform- 
+    std::unordered_map<std::string, UniformSlot> uniformSlots;
+
+    // ---   ---
+    bool ready = true;
+    bool failed = false;
+    bool separable = false; //  : uniform-   glProgramUniform*
+
+    //  ,     
+    struct PendingShader {
+        GLuint shader;
+        const char* type;
+    };
+    std::vector<PendingShader> pendingShaders;
+
+    //      
+    class ProgramBinaryCache* pendingCache = nullptr;
+    std::string pendingCacheKey;
+
+    // ---   (   ) ---
+    GLuint pipelineID = 0;
+    std::shared_ptr<Shader> vertexStage;
+    std::shared_ptr<Shader> fragmentStage;
+
+    //   
+    StandardUniforms standard;
+
     //     
     void checkCompileErrors(unsigned int shader, std::string type);
+
+    /**
+     * @brief        .
+     * @param sources  "  OpenGL -  ".
+     * @param cacheKey    ( -  ).
+     */
+    void submitBuild(const std::vector<std::pair<GLenum, std::string>>& sources,
+                     class ProgramBinaryCache* binaryCache, const std::string& cacheKey);
+
+    //   ,      uniform-
+    void completeBuild();
+
+    //     (   )
+    void mergeStageUniforms();
+
+    //  #define   #version (     )
+    static std::string injectDefines(const std::string& source, const std::string& defines);
+
+    //   uniform- (glGetActiveUniform)   
+    // separable:   ID    ( glProgramUniform*)
+    void buildUniformTable(bool separable = false);
+
+    //   StandardUniforms  
+    void resolveStandardUniforms();
+
+    //   CameraData / LightData / MaterialData / InstanceData   
+    // ( GLSL 3.30  layout(binding),         )
+    void bindUniformBlocks();
 };
\ No newline at end of file
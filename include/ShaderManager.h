@@ -1,38 +1,271 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <stdexcept>
+#include <vector>
 #include "Shader.h"
 #include "Material.h" //   enum class LightingModel
+#include "AssetRegistry.h"
+#include "ProgramBinaryCache.h"
+
+/**
+ * @brief   ()  .
+ *     #define,     
+ *  ,   :  ,    .
+ * ShaderManager  #define    #version:
+ *  - NUM_POINT_LIGHTS / NUM_SPOT_LIGHTS -    (  );
+ *  - NO_DIR_LIGHT -     ;
+ *  - NO_TEXTURE   -   ,   ;
+ *  - NO_SPECULAR  -    specular,   ;
+ *  - CLUSTERED_LIGHTING -        .
+ *   #define  :     uniform-.
+ */
+struct ShaderVariantKey {
+    LightingModel model = LightingModel::PHONG;
+    int numPointLights = 0;   // 0..MAX_POINT_LIGHTS
+    int numSpotLights = 0;    // 0..MAX_SPOT_LIGHTS
+    bool dirLight = true;     //    
+    bool textured = true;     //     
+    bool specular = true;     //    
+    bool clustered = false;   //     -    (LightClusters),   
+
+    //       
+    uint32_t packed() const;
+
+    //  #define,   #version
+    std::string defines() const;
+};
 
 /**
  * @brief   ,      .
+ *   : loadAllShaders()      ,
+ *     getShader()   ( ) .
  */
 class ShaderManager {
 public:
-    ShaderManager();
+    /**
+     * @brief  .
+     * @param registry  ,    .
+     */
+    explicit ShaderManager(AssetRegistry& registry);
+
+    //   
+    ~ShaderManager();
 
     //  
     ShaderManager(const ShaderManager&) = delete;
     ShaderManager& operator=(const ShaderManager&) = delete;
 
-    //       res/shaders/
+    //       res/shaders/ (   )
     void loadAllShaders();
 
+    //   ;    
+    void update();
+
+    //       ()
+    void finishAll();
+
+    //     (  )
+    bool isIdle() const { return pendingPrograms.empty(); }
+
     /**
      * @brief       .
      * @param model    (PHONG, TOON_SHADING, CUSTOM_MODEL).
-     * @return Shader&    .
+     * @return Shader&     (,    ).
      * @throws std::runtime_error    .
      */
     Shader& getShader(LightingModel model);
 
+    /**
+     * @brief   ,   .
+     *     ,       ( ).
+     * @param key  ,      .
+     * @return Shader&    (   ,        ).
+     */
+    Shader& getShader(const ShaderVariantKey& key);
+
+    /**
+     * @brief   ,      .
+     * @param keys   ( ).
+     */
+    void precompileVariants(const std::vector<ShaderVariantKey>& keys);
+
+    //   
+    size_t getVariantCount() const { return variants.size(); }
+
+    /**
+     * @brief  (uber.vert + uber.frag):      .
+     *     ,   .
+     *   ,    .
+     * @param clustered     (   ).
+     * @throws std::runtime_error       .
+     */
+    Shader& getUberShader(bool clustered = false);
+
+    /**
+     * @brief  -    (base.vert +   ).
+     *      .
+     */
+    Shader& getOcclusionShader();
+
+    /**
+     * @brief    ( DEFERRED, . Scene::addDeferredPasses):
+     *   (uber.vert + gbuffer.frag)    (deferred.vert + deferred.frag).
+     *    ;    .
+     * @param clustered      .
+     * @throws std::runtime_error       .
+     */
+    Shader& getGeometryPassShader();
+    Shader& getLightingPassShader(bool clustered = false);
+
+    /**
+     * @brief    (. Scene::setAntialiasing): FXAA  
+     *     MSAA (deferred.vert + fxaa.frag / msaa_resolve.frag).
+     *    .
+     * @param multisample   MSAA  FXAA.
+     * @throws std::runtime_error       .
+     */
+    Shader& getAntialiasingShader(bool multisample);
+
+    /**
+     * @brief         (deferred.vert + upscale.frag,
+     * . Scene::setRenderScale).    .
+     * @throws std::runtime_error       .
+     */
+    Shader& getUpscaleShader();
+
+    /**
+     * @brief   GPU_DRIVEN (. IndirectRenderer):    
+     * (cull.comp)    (indirect.vert + uber.frag).    .
+     * @param clustered    .
+     * @throws std::runtime_error       .
+     */
+    Shader& getIndirectCullShader();
+    Shader& getIndirectDrawShader(bool clustered = false);
+
+    /**
+     * @brief     (. ImpostorAtlas):  
+     * (impostor_bake.vert + impostor_bake.frag)    -  
+     * (impostor.vert + uber.frag)   G- (impostor.vert + gbuffer.frag),   #define IMPOSTOR.
+     *    .
+     * @param clustered    .
+     * @throws std::runtime_error       .
+     */
+    Shader& getImpostorBakeShader();
+    Shader& getImpostorShader(bool clustered = false);
+    Shader& getImpostorGeometryPassShader();
+
+    //       
+    bool isUsingPipeline() const { return pipeline != 0; }
+
 private:
     //   .  -  ,  -   Shader.
-    std::map<LightingModel, std::unique_ptr<Shader>> shaders;
+    std::map<LightingModel, std::shared_ptr<Shader>> shaders;
+
+    //     (  )
+    std::map<LightingModel, std::string> fragmentPaths;
+
+    //  .  - ShaderVariantKey::packed()
+    std::map<uint32_t, std::shared_ptr<Shader>> variants;
+
+    //     (  ,   )
+    std::shared_ptr<Shader> uberShader;
+    std::shared_ptr<Shader> clusteredUberShader;
+
+    //    ,  :  ,   
+    std::shared_ptr<Shader> fallbackShader;
+
+    // -   ( ,   )
+    std::shared_ptr<Shader> occlusionShader;
+
+    //    (     DEFERRED)
+    std::shared_ptr<Shader> geometryPassShader;
+    std::shared_ptr<Shader> lightingPassShader;
+    std::shared_ptr<Shader> clusteredLightingPassShader;
+
+    //    (   )
+    std::shared_ptr<Shader> fxaaShader;
+    std::shared_ptr<Shader> msaaResolveShader;
+
+    //     (    )
+    std::shared_ptr<Shader> upscaleShader;
+
+    //   GPU_DRIVEN (    )
+    std::shared_ptr<Shader> indirectCullShader;
+    std::shared_ptr<Shader> indirectDrawShader;
+    std::shared_ptr<Shader> clusteredIndirectDrawShader;
+
+    //   (     )
+    std::shared_ptr<Shader> impostorBakeShader;
+    std::shared_ptr<Shader> impostorShader;
+    std::shared_ptr<Shader> clusteredImpostorShader;
+    std::shared_ptr<Shader> impostorGeometryPassShader;
+
+    // ,     
+    std::vector<std::shared_ptr<Shader>> pendingPrograms;
+
+    //         
+    std::chrono::steady_clock::time_point buildStart;
+    bool allReadyReported = false;
+
+    //   (        )
+    AssetRegistry& assetRegistry;
+
+    //      (     )
+    ProgramBinaryCache binaryCache;
+
+    //    (0,  ARB_separate_shader_objects )
+    GLuint pipeline;
+
+    //  ,     
+    std::shared_ptr<Shader> baseVertexStage;
+
+    //       (   )
+    bool vertexStageBound = false;
 
     //     
     const std::string BASE_VERTEX_PATH = "src/res/shaders/base.vert";
+
+    //      
+    const std::string FALLBACK_FRAGMENT_PATH = "src/res/shaders/fallback.frag";
+
+    //     -
+    const std::string OCCLUSION_FRAGMENT_PATH = "src/res/shaders/occlusion.frag";
+
+    //     
+    const std::string GBUFFER_FRAGMENT_PATH = "src/res/shaders/gbuffer.frag";
+    const std::string DEFERRED_VERTEX_PATH = "src/res/shaders/deferred.vert";
+    const std::string DEFERRED_FRAGMENT_PATH = "src/res/shaders/deferred.frag";
+
+    //      ( -   deferred.vert)
+    const std::string FXAA_FRAGMENT_PATH = "src/res/shaders/fxaa.frag";
+    const std::string MSAA_RESOLVE_FRAGMENT_PATH = "src/res/shaders/msaa_resolve.frag";
+    const std::string UPSCALE_FRAGMENT_PATH = "src/res/shaders/upscale.frag";
+
+    //     GPU_DRIVEN ( - uber.frag)
+    const std::string INDIRECT_CULL_COMPUTE_PATH = "src/res/shaders/cull.comp";
+    const std::string INDIRECT_VERTEX_PATH = "src/res/shaders/indirect.vert";
+
+    //     (   - uber.frag  gbuffer.frag)
+    const std::string IMPOSTOR_VERTEX_PATH = "src/res/shaders/impostor.vert";
+    const std::string IMPOSTOR_BAKE_VERTEX_PATH = "src/res/shaders/impostor_bake.vert";
+    const std::string IMPOSTOR_BAKE_FRAGMENT_PATH = "src/res/shaders/impostor_bake.frag";
+
+    /**
+     * @brief        .
+     *       .
+     * @param defines #define  (  -  ).
+     */
+    std::shared_ptr<Shader> loadLightingShader(const std::string& fragmentPath, const std::string& defines = "");
+
+    /**
+     * @brief         
+     *        .
+     * @return false,         (   ).
+     */
+    bool acquireReady(const std::shared_ptr<Shader>& shader);
 };
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Frustum.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief        .
+ */
+struct AABB {
+    Vec3 min;
+    Vec3 max;
+
+    bool contains(const AABB& other) const;
+    AABB merged(const AABB& other) const;
+    float surfaceArea() const;
+};
+
+/**
+ * @brief     (BVH)   AABB .
+ *
+ *   -   (proxy).    AABB   FAT_MARGIN,
+ *      ;       
+ *  ,    (refit)  .   
+ *    ,    ,   AVL-.
+ *
+ *        :   
+ * (   -      ),     .
+ */
+class SpatialIndex {
+public:
+    static constexpr int NULL_NODE = -1;
+
+    //   AABB  (  )
+    static constexpr float FAT_MARGIN = 0.1f;
+
+    struct RayHit {
+        uint32_t userData;
+        float distance;   //       AABB  (0,   )
+    };
+
+    /**
+     * @brief  .
+     * @param bounds  AABB .
+     * @param userData ,    (,  ).
+     * @return    move()  remove().
+     */
+    int insert(const AABB& bounds, uint32_t userData);
+
+    void remove(int proxy);
+
+    /**
+     * @brief      .
+     * @return true,    ( AABB   ).
+     */
+    bool move(int proxy, const AABB& bounds);
+
+    //  
+    size_t size() const { return proxyCount; }
+
+    // ---  ---
+
+    /**
+     * @brief ,  AABB    .
+     * @param inside   ,    .
+     * @param intersecting ,    (  ).
+     */
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& inside, std::vector<uint32_t>& intersecting) const;
+
+    // , AABB   
+    void querySphere(const Vec3& center, float radius, std::vector<uint32_t>& result) const;
+
+    // , AABB      [0, maxDistance] (direction -  )
+    void queryRay(const Vec3& origin, const Vec3& direction, float maxDistance, std::vector<RayHit>& result) const;
+
+    //   ( :   ~ log2  )
+    int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+private:
+    struct Node {
+        AABB bounds;
+        int parent = NULL_NODE;
+        int child1 = NULL_NODE;
+        int child2 = NULL_NODE;
+        int height = -1;          // 0 - , -1 -  
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int root = NULL_NODE;
+    int freeList = NULL_NODE;     //      parent
+    size_t proxyCount = 0;
+
+    //   ( );   -     
+    mutable std::vector<int> stack;
+    mutable std::vector<std::pair<int, int>> frustumStack;
+
+    int allocateNode();
+    void freeNode(int node);
+
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+
+    //  AABB        
+    void refitFrom(int node);
+    int balance(int node);
+
+    //      
+    void collectLeaves(int node, std::vector<uint32_t>& result) const;
+};
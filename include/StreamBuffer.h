@@ -0,0 +1,121 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief         GPU.
+ *
+ *    FRAMES_IN_FLIGHT ,    .   
+ *       (allocate),     
+ *    (bindRange).     ,  GPU
+ *  ,    (glFenceSync),   CPU   .
+ *
+ * :
+ *  - ARB_buffer_storage:    (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT),
+ *    allocate()      , flush()   ;
+ *  -  :      CPU   glBufferSubData  flush(),
+ *            (orphaning: glBufferData  nullptr),
+ *       ,     .
+ */
+class StreamBuffer {
+public:
+    static constexpr int FRAMES_IN_FLIGHT = 3;
+
+    //    
+    struct Allocation {
+        void* data = nullptr;   //   (nullptr -   )
+        GLintptr offset = 0;    //   
+        GLsizeiptr size = 0;
+    };
+
+    struct Stats {
+        size_t allocations = 0;
+        size_t bytes = 0;
+        size_t stalls = 0;      // ,     GPU
+        size_t overflows = 0;   // ,     
+    };
+
+    /**
+     * @brief .    OpenGL.
+     * @param target   (GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER, ...).
+     * @param frameSize      .
+     */
+    StreamBuffer(GLenum target, GLsizeiptr frameSize);
+    ~StreamBuffer();
+
+    //   (     OpenGL)
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+     * @brief     regionSize  (    ).
+     *   ;   ,      .
+     *   beginFrame:     .
+     */
+    void reserve(GLsizeiptr regionSize);
+
+    //    ;   ,  GPU  
+    void beginFrame();
+
+    //   (fence)   ,   
+    void endFrame();
+
+    /**
+     * @brief      .
+     * @param size   .
+     * @param alignment   (, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT).
+     */
+    Allocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+
+    //   uniform- ( ,   )
+    Allocation allocateUniform(GLsizeiptr size) { return allocate(size, uniformAlignment); }
+
+    //      uniform-  size   
+    GLsizeiptr uniformSpan(GLsizeiptr size) const {
+        return ((size + uniformAlignment - 1) / uniformAlignment) * uniformAlignment;
+    }
+
+    //      GPU (   -  )
+    void flush(const Allocation& allocation);
+
+    //        
+    void bindRange(GLuint bindingIndex, const Allocation& allocation) const;
+
+    /**
+     * @brief  ,    :    
+     * (glBufferData   ,   )     bindingIndex.
+     */
+    void uploadOverflow(GLuint bindingIndex, const void* data, GLsizeiptr size);
+
+    GLuint getID() const { return bufferID; }
+    GLsizeiptr getFrameSize() const { return frameSize; }
+    bool isPersistent() const { return persistent; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    GLenum target;
+    GLuint bufferID = 0;
+    GLuint overflowBufferID = 0;   //    
+    GLsizeiptr frameSize;
+    GLsizeiptr uniformAlignment = 256;
+    bool persistent = false;
+
+    //   (persistent)    CPU ( )
+    char* mapped = nullptr;
+    std::vector<char> shadow;
+
+    int frameIndex = FRAMES_IN_FLIGHT - 1;
+    GLsizeiptr cursor = 0;
+    GLsync fences[FRAMES_IN_FLIGHT] = {};
+
+    Stats stats;
+
+    //    (   )
+    void waitForRegion(int region);
+
+    //      FRAMES_IN_FLIGHT   frameSize 
+    void createStorage();
+    void releaseStorage();
+};
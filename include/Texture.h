@@ -16,6 +16,18 @@ public:
     //     SFML    OpenGL
     Texture(const std::string& filePath, bool flipVertically = true);
 
+    /**
+     * @brief      ( ,   CPU).
+     *  mipmap-,  GL_CLAMP_TO_EDGE.
+     * @param width   .
+     * @param height   .
+     * @param internalFormat   (, GL_R16F).
+     * @param format    (GL_RED, GL_RG, ...).
+     * @param pixels   ,    (v = 0).
+     * @param filter  (GL_LINEAR  GL_NEAREST -   ).
+     */
+    Texture(int width, int height, GLenum internalFormat, GLenum format, const float* pixels, GLint filter = GL_LINEAR);
+
     //   (..   OpenGL)
     Texture(const Texture&) = delete;
     Texture& operator=(const Texture&) = delete;
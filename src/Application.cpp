@@ -1,4 +1,5 @@
 #include "../include/Application.h"
+#include "../include/GLStateCache.h"
 
 #include <iostream>
 #include <stdexcept>
@@ -8,7 +9,7 @@
 // ----------------------------------------------------------------------
 
 Application::Application(int width, int height, const std::string& title)
-    : firstMouse(true), lastX(width / 2.0f), lastY(height / 2.0f)
+    : firstMouse(true), lastX(width / 2.0f), lastY(height / 2.0f), statsTime(0.0f), statsFrames(0)
 {
     if (!initialize(width, height, title)) {
         throw std::runtime_error("Application initialization failed.");
@@ -20,7 +21,8 @@ bool Application::initialize(int width, int height, const std::string& title) {
     sf::ContextSettings settings;
     settings.depthBits = 24;
     settings.stencilBits = 8;
-    settings.antialiasingLevel = 4;
+    //  :  (FXAA  MSAA)    , . Scene::setAntialiasing
+    settings.antialiasingLevel = 0;
     settings.majorVersion = 3;
     settings.minorVersion = 3;
 
@@ -36,14 +38,15 @@ bool Application::initialize(int width, int height, const std::string& title) {
     }
 
     //    (  3D)
-    glEnable(GL_DEPTH_TEST);
+    GLStateCache::get().enable(GL_DEPTH_TEST);
 
     //    (viewport)
     glViewport(0, 0, width, height);
 
     // ---   ---
     try {
-        shaderManager = std::make_unique<ShaderManager>();
+        assetRegistry = std::make_unique<AssetRegistry>();
+        shaderManager = std::make_unique<ShaderManager>(*assetRegistry);
         // :    (Phong, Toon, Custom)    
         shaderManager->loadAllShaders();
 
@@ -54,8 +57,11 @@ bool Application::initialize(int width, int height, const std::string& title) {
         camera->MouseSensitivity = MOUSE_SENSITIVITY;
 
         //     
-        scene = std::make_unique<Scene>(*shaderManager);
+        scene = std::make_unique<Scene>(*shaderManager, *assetRegistry);
         scene->setupScene(); // ,    5+   
+        assetRegistry->printStats();
+
+        governor = std::make_unique<QualityGovernor>();
 
     }
     catch (const std::exception& e) {
@@ -81,6 +87,7 @@ void Application::run() {
         render();
 
         window.display();
+        reportFrameStats(deltaTime);
     }
 }
 
@@ -99,6 +106,69 @@ void Application::handleEvents() {
         case sf::Event::KeyPressed:
             if (event.key.code == sf::Keyboard::Escape)
                 window.close();
+
+            // U:    (  ->  ->  
+            // ->   GPU,    )
+            if (event.key.code == sf::Keyboard::U) {
+                RenderMode mode = scene->getRenderMode();
+                RenderMode afterDeferred = IndirectRenderer::isSupported() ? RenderMode::GPU_DRIVEN : RenderMode::PER_MODEL;
+                scene->setRenderMode(mode == RenderMode::PER_MODEL ? RenderMode::UBERSHADER
+                    : mode == RenderMode::UBERSHADER ? RenderMode::DEFERRED
+                    : mode == RenderMode::DEFERRED ? afterDeferred : RenderMode::PER_MODEL);
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // O: /    ( )
+            if (event.key.code == sf::Keyboard::O) {
+                scene->setOcclusionCulling(!scene->isOcclusionCullingEnabled());
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // C: /   (   CPU)
+            if (event.key.code == sf::Keyboard::C) {
+                scene->setSoftwareOcclusion(!scene->isSoftwareOcclusionEnabled());
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // M:   ( -> FXAA -> MSAA 2x -> 4x -> 8x)
+            if (event.key.code == sf::Keyboard::M) {
+                int next = (static_cast<int>(scene->getAntialiasing()) + 1) % (static_cast<int>(AntialiasingMode::MSAA_8X) + 1);
+                governor->reset(*scene);
+                scene->setAntialiasing(static_cast<AntialiasingMode>(next));
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // G: /   (   )
+            if (event.key.code == sf::Keyboard::G) {
+                governor->setEnabled(!governor->isEnabled(), *scene);
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // K:    /     
+            if (event.key.code == sf::Keyboard::K) {
+                scene->setClusteredLighting(!scene->isClusteredLightingEnabled());
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // N:    (     )
+            if (event.key.code == sf::Keyboard::N) {
+                scene->addLanternRing();
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
+
+            // I:    (   / )
+            if (event.key.code == sf::Keyboard::I) {
+                scene->setImpostorThreshold(scene->getImpostorThreshold() > 0.0f ? 0.0f : Scene::DEFAULT_IMPOSTOR_THRESHOLD);
+                statsTime = 0.0f;
+                statsFrames = 0;
+            }
             break;
 
         case sf::Event::MouseMoved: {
@@ -138,6 +208,9 @@ void Application::handleEvents() {
 }
 
 void Application::update(float deltaTime) {
+    //  ,     
+    shaderManager->update();
+
     //      
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::W))
         camera->processKeyboard(CameraMovement::FORWARD, deltaTime);
@@ -189,4 +262,37 @@ void Application::render() {
 
     // 2.  
     scene->render(*camera);
+
+    // 3.    GPU-  (    )
+    governor->update(*scene);
+}
+
+void Application::reportFrameStats(float deltaTime) {
+    statsTime += deltaTime;
+    statsFrames++;
+    if (statsTime < STATS_INTERVAL) {
+        return;
+    }
+
+    const Scene::RenderStats& stats = scene->getRenderStats();
+    std::cout << "INFO::APPLICATION: ["
+              << renderModeName(scene->getRenderMode()) << ", " << antialiasingModeName(scene->getAntialiasing()) << "] "
+              << (statsTime * 1000.0f / statsFrames) << " ms/frame, "
+              << stats.gpuFrameMs << " ms GPU (antialiasing " << stats.gpuAntialiasingMs << " ms), "
+              << "render scale " << scene->getRenderScale() << (governor->isEnabled() ? " (governed), " : ", ")
+              << stats.drawCalls << " draw calls (" << stats.indirectCommands << " indirect commands), "
+              << stats.programSwitches << " program switches, "
+              << stats.objectsCulled << " objects culled, "
+              << stats.objectsOccluded << " occluded (" << stats.occlusionQueries << " queries), "
+              << stats.objectsRasterOccluded << " occluded on CPU, "
+              << stats.objectLightsCulled << " object-light pairs culled, "
+              << stats.impostors << " impostors, "
+              << stats.clusterLightReferences << " cluster light refs (max " << stats.maxLightsPerCluster << "), "
+              << stats.renderPasses << " passes, " << stats.renderTargetBytes / 1024 << " KB render targets ("
+              << stats.renderTargetBytesUnaliased / 1024 << " KB without aliasing), "
+              << stats.stateChangesIssued << " state changes ("
+              << stats.stateChangesSkipped << " redundant skipped)." << std::endl;
+
+    statsTime = 0.0f;
+    statsFrames = 0;
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "../include/AssetRegistry.h"
+#include "../include/MeshParser.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+std::string AssetRegistry::canonicalPath(const std::string& filePath) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(filePath, ec);
+    if (ec) {
+        //     (,  ) -   
+        return std::filesystem::path(filePath).lexically_normal().generic_string();
+    }
+    return canonical.generic_string();
+}
+
+uint64_t AssetRegistry::hashBytes(const void* data, size_t size, uint64_t seed) {
+    // FNV-1a:   ,    
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t AssetRegistry::hashFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("ERROR::ASSET_REGISTRY: Could not open file: " + filePath);
+    }
+
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return hashBytes(content.data(), content.size());
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+template <typename T>
+std::shared_ptr<T> AssetRegistry::acquire(Cache<T>& cache, AssetType type, const std::string& pathKey,
+                                          const std::function<uint64_t()>& contentHash,
+                                          const std::function<std::shared_ptr<T>()>& load) {
+    Stats& typeStats = statsFor(type);
+
+    // 1.  :        
+    auto pathIt = cache.byPath.find(pathKey);
+    if (pathIt != cache.byPath.end()) {
+        if (auto existing = pathIt->second.lock()) {
+            typeStats.hits++;
+            return existing;
+        }
+    }
+
+    // 2.  ,     ( ,   ..)
+    uint64_t hash = contentHash();
+    auto contentIt = cache.byContent.find(hash);
+    if (contentIt != cache.byContent.end()) {
+        if (auto existing = contentIt->second.lock()) {
+            cache.byPath[pathKey] = existing;
+            typeStats.hits++;
+            return existing;
+        }
+    }
+
+    // 3. :        
+    std::shared_ptr<T> loaded = load();
+    cache.byPath[pathKey] = loaded;
+    cache.byContent[hash] = loaded;
+    typeStats.misses++;
+    return loaded;
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+std::shared_ptr<Mesh> AssetRegistry::loadMesh(const std::string& filePath) {
+    std::string key = canonicalPath(filePath);
+
+    return acquire<Mesh>(meshes, AssetType::MESH, key,
+        [&]() { return hashFile(filePath); },
+        [&]() { return std::make_shared<Mesh>(MeshParser::parseObj(filePath)); });
+}
+
+std::shared_ptr<Mesh> AssetRegistry::loadPlatformMesh(const std::string& filePath,
+                                                      float scaleX, float scaleY, float scaleZ) {
+    const float scales[3] = { scaleX, scaleY, scaleZ };
+    std::string key = canonicalPath(filePath) + "|platform|" +
+        std::to_string(scaleX) + "," + std::to_string(scaleY) + "," + std::to_string(scaleZ);
+
+    return acquire<Mesh>(meshes, AssetType::MESH, key,
+        [&]() { return hashBytes(scales, sizeof(scales), hashFile(filePath)); },
+        [&]() { return std::make_shared<Mesh>(MeshParser::parseCubeAsPlatform(filePath, scaleX, scaleY, scaleZ)); });
+}
+
+std::shared_ptr<Texture> AssetRegistry::loadTexture(const std::string& filePath, bool flipVertically) {
+    std::string key = canonicalPath(filePath) + (flipVertically ? "|flip" : "|noflip");
+
+    return acquire<Texture>(textures, AssetType::TEXTURE, key,
+        [&]() { return hashBytes(&flipVertically, sizeof(flipVertically), hashFile(filePath)); },
+        [&]() { return std::make_shared<Texture>(filePath, flipVertically); });
+}
+
+std::shared_ptr<Shader> AssetRegistry::loadShader(const std::string& vertexPath, const std::string& fragmentPath,
+                                                 ProgramBinaryCache* binaryCache, const std::string& defines,
+                                                 bool asynchronous) {
+    std::string key = canonicalPath(vertexPath) + "|" + canonicalPath(fragmentPath) + "|" + defines;
+
+    return acquire<Shader>(shaders, AssetType::SHADER, key,
+        [&]() { return hashBytes(defines.data(), defines.size(), hashFile(fragmentPath) ^ (hashFile(vertexPath) * 31)); },
+        [&]() { return std::make_shared<Shader>(vertexPath.c_str(), fragmentPath.c_str(), binaryCache, defines, asynchronous); });
+}
+
+std::shared_ptr<Shader> AssetRegistry::loadShaderStage(ShaderStage stage, const std::string& path,
+                                                      ProgramBinaryCache* binaryCache, const std::string& defines,
+                                                      bool asynchronous) {
+    //    :         
+    std::string key = canonicalPath(path) + (stage == ShaderStage::VERTEX ? "|vertex|"
+                                             : stage == ShaderStage::FRAGMENT ? "|fragment|" : "|compute|") + defines;
+
+    return acquire<Shader>(shaders, AssetType::SHADER, key,
+        [&]() { return hashBytes(defines.data(), defines.size(), hashBytes(&stage, sizeof(stage), hashFile(path))); },
+        [&]() { return std::make_shared<Shader>(stage, path.c_str(), binaryCache, defines, asynchronous); });
+}
+
+std::shared_ptr<Material> AssetRegistry::getMaterial(const Vec3& ambient, const Vec3& diffuse, const Vec3& specular,
+                                                     float shininess, std::shared_ptr<Texture> texture,
+                                                     LightingModel lightingModel) {
+    //    :      .
+    //     -     .
+    const float values[10] = {
+        ambient.x, ambient.y, ambient.z,
+        diffuse.x, diffuse.y, diffuse.z,
+        specular.x, specular.y, specular.z,
+        shininess
+    };
+    const Texture* texturePtr = texture.get();
+
+    uint64_t hash = hashBytes(values, sizeof(values));
+    hash = hashBytes(&texturePtr, sizeof(texturePtr), hash);
+    hash = hashBytes(&lightingModel, sizeof(lightingModel), hash);
+
+    Stats& typeStats = statsFor(AssetType::MATERIAL);
+
+    auto it = materials.find(hash);
+    if (it != materials.end()) {
+        if (auto existing = it->second.lock()) {
+            typeStats.hits++;
+            return existing;
+        }
+    }
+
+    auto material = std::make_shared<Material>(ambient, diffuse, specular, shininess, texture, lightingModel);
+    materials[hash] = material;
+    typeStats.misses++;
+    return material;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+template <typename Map>
+static void eraseExpired(Map& table) {
+    for (auto it = table.begin(); it != table.end();) {
+        if (it->second.expired()) {
+            it = table.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+template <typename Map>
+static size_t countLive(const Map& table) {
+    size_t count = 0;
+    for (const auto& entry : table) {
+        if (!entry.second.expired()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void AssetRegistry::collectGarbage() {
+    eraseExpired(meshes.byPath);
+    eraseExpired(meshes.byContent);
+    eraseExpired(textures.byPath);
+    eraseExpired(textures.byContent);
+    eraseExpired(shaders.byPath);
+    eraseExpired(shaders.byContent);
+    eraseExpired(materials);
+}
+
+AssetRegistry::Stats AssetRegistry::getStats(AssetType type) const {
+    Stats result = stats[static_cast<size_t>(type)];
+
+    //      :        
+    switch (type) {
+    case AssetType::MESH:     result.live = countLive(meshes.byContent); break;
+    case AssetType::TEXTURE:  result.live = countLive(textures.byContent); break;
+    case AssetType::SHADER:   result.live = countLive(shaders.byContent); break;
+    case AssetType::MATERIAL: result.live = countLive(materials); break;
+    default: break;
+    }
+    return result;
+}
+
+void AssetRegistry::printStats() const {
+    static const char* names[] = { "Meshes", "Textures", "Materials", "Shaders" };
+
+    std::cout << "INFO::ASSET_REGISTRY: Cache statistics:" << std::endl;
+    for (size_t i = 0; i < static_cast<size_t>(AssetType::COUNT); ++i) {
+        Stats s = getStats(static_cast<AssetType>(i));
+        std::cout << "  - " << names[i] << ": " << s.hits << " hits, " << s.misses
+                  << " misses, " << s.live << " live." << std::endl;
+    }
+}
@@ -29,6 +29,16 @@ void Camera::getProjectionMatrix(float projectionMatrix[16]) const {
     MathUtils::createPerspective(Zoom, aspectRatio, nearPlane, farPlane, projectionMatrix);
 }
 
+void Camera::getFrustum(Frustum& frustum) const {
+    float view[16];
+    float projection[16];
+    float viewProjection[16];
+    getViewMatrix(view);
+    getProjectionMatrix(projection);
+    MathUtils::multiplyMatrix4x4(projection, view, viewProjection);
+    frustum.extract(viewProjection);
+}
+
 void Camera::processKeyboard(CameraMovement direction, float deltaTime) {
     float velocity = MovementSpeed * deltaTime;
 
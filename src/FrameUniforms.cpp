@@ -0,0 +1,73 @@
+#include "../include/FrameUniforms.h"
+#include "../include/GLStateCache.h"
+#include <cstddef>
+#include <cstring>
+
+//      std140  
+static_assert(sizeof(FrameUniforms::CameraBlock) == 144, "CameraData layout mismatch");
+static_assert(sizeof(FrameUniforms::DirLightBlock) == 32, "DirLight std140 size mismatch");
+static_assert(sizeof(FrameUniforms::PointLightBlock) == 48, "PointLight std140 size mismatch");
+static_assert(sizeof(FrameUniforms::SpotLightBlock) == 64, "SpotLight std140 size mismatch");
+static_assert(offsetof(FrameUniforms::LightBlock, numPointLights) == 352, "LightData layout mismatch");
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+FrameUniforms::FrameUniforms() {
+    //      ;       
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    GLintptr cameraSize = sizeof(CameraBlock);
+    lightsOffset = ((cameraSize + alignment - 1) / alignment) * alignment;
+
+    glGenBuffers(1, &bufferID);
+    GLStateCache& state = GLStateCache::get();
+    state.bindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    glBufferData(GL_UNIFORM_BUFFER, lightsOffset + sizeof(LightBlock), nullptr, GL_DYNAMIC_DRAW);
+
+    state.bindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, bufferID, 0, sizeof(CameraBlock));
+    state.bindBufferRange(GL_UNIFORM_BUFFER, LIGHTS_BLOCK_BINDING, bufferID, lightsOffset, sizeof(LightBlock));
+}
+
+FrameUniforms::~FrameUniforms() {
+    if (bufferID != 0) {
+        GLStateCache::get().forgetBuffer(bufferID);
+        glDeleteBuffers(1, &bufferID);
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void FrameUniforms::update(const CameraBlock& camera, const LightBlock& lights) {
+    //     ,     
+    bool cameraDirty = !hasUploaded || std::memcmp(&camera, &uploadedCamera, sizeof(CameraBlock)) != 0;
+    bool lightsDirty = !hasUploaded || std::memcmp(&lights, &uploadedLights, sizeof(LightBlock)) != 0;
+
+    if (!cameraDirty && !lightsDirty) {
+        stats.skipped += 2;
+        return;
+    }
+
+    GLStateCache::get().bindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    if (cameraDirty) {
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &camera);
+        uploadedCamera = camera;
+        stats.uploads++;
+    }
+    else {
+        stats.skipped++;
+    }
+
+    if (lightsDirty) {
+        glBufferSubData(GL_UNIFORM_BUFFER, lightsOffset, sizeof(LightBlock), &lights);
+        uploadedLights = lights;
+        stats.uploads++;
+    }
+    else {
+        stats.skipped++;
+    }
+    hasUploaded = true;
+}
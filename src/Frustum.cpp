@@ -0,0 +1,177 @@
+#include "../include/Frustum.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_CULLER_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_CULLER_SSE
+#endif
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void Frustum::extract(const float m[16]) {
+    //  i   : (m[i], m[4 + i], m[8 + i], m[12 + i])
+    auto combine = [&](int plane, int row, float sign) {
+        for (int k = 0; k < 4; ++k) {
+            planes[plane][k] = m[k * 4 + 3] + sign * m[k * 4 + row];
+        }
+    };
+    combine(LEFT, 0, 1.0f);
+    combine(RIGHT, 0, -1.0f);
+    combine(BOTTOM, 1, 1.0f);
+    combine(TOP, 1, -1.0f);
+    combine(NEAR_PLANE, 2, 1.0f);
+    combine(FAR_PLANE, 2, -1.0f);
+
+    // ,        
+    for (auto& plane : planes) {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            for (float& component : plane) {
+                component /= length;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+const char* FrustumCuller::instructionSet() {
+#if defined(FRUSTUM_CULLER_AVX)
+    return "AVX, 8 spheres per test";
+#elif defined(FRUSTUM_CULLER_SSE)
+    return "SSE, 4 spheres per test";
+#else
+    return "scalar";
+#endif
+}
+
+void FrustumCuller::resize(size_t newCount) {
+    count = newCount;
+    size_t padded = (newCount + LANES - 1) / LANES * LANES;
+
+    //      ,     
+    centerX.resize(padded, 0.0f);
+    centerY.resize(padded, 0.0f);
+    centerZ.resize(padded, 0.0f);
+    radius.resize(padded, -1.0f);
+}
+
+void FrustumCuller::setSphere(size_t index, float x, float y, float z, float r) {
+    centerX[index] = x;
+    centerY[index] = y;
+    centerZ[index] = z;
+    radius[index] = r;
+}
+
+//   4  -> 4   0/1 (   )   
+namespace {
+    struct MaskExpansion {
+        uint8_t bytes[16][4];
+        uint8_t bits[16];
+        MaskExpansion() {
+            for (int mask = 0; mask < 16; ++mask) {
+                bits[mask] = 0;
+                for (int k = 0; k < 4; ++k) {
+                    bytes[mask][k] = static_cast<uint8_t>((mask >> k) & 1);
+                    bits[mask] += bytes[mask][k];
+                }
+            }
+        }
+    };
+    const MaskExpansion maskExpansion;
+
+    //     4  (    )
+    size_t storeMask4(int mask, uint8_t* out, size_t lanes) {
+        if (lanes >= 4) {
+            std::memcpy(out, maskExpansion.bytes[mask], 4);
+            return maskExpansion.bits[mask];
+        }
+        mask &= (1 << lanes) - 1;
+        std::memcpy(out, maskExpansion.bytes[mask], lanes);
+        return maskExpansion.bits[mask];
+    }
+}
+
+size_t FrustumCuller::cull(const Frustum& frustum, std::vector<uint8_t>& visible) {
+    visible.resize(count);
+    size_t visibleCount = 0;
+
+#if defined(FRUSTUM_CULLER_AVX)
+    //         
+    __m256 planes[Frustum::PLANE_COUNT][4];
+    for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+        for (int k = 0; k < 4; ++k) {
+            planes[p][k] = _mm256_set1_ps(frustum.planes[p][k]);
+        }
+    }
+
+    for (size_t base = 0; base < count; base += 8) {
+        __m256 x = _mm256_loadu_ps(&centerX[base]);
+        __m256 y = _mm256_loadu_ps(&centerY[base]);
+        __m256 z = _mm256_loadu_ps(&centerZ[base]);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&radius[base]));
+
+        //  ,        
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const auto& plane : planes) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, plane[0]), _mm256_mul_ps(y, plane[1])),
+                                     _mm256_add_ps(_mm256_mul_ps(z, plane[2]), plane[3]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        size_t lanes = count - base;
+        visibleCount += storeMask4(mask & 0xF, &visible[base], lanes);
+        if (lanes > 4) {
+            visibleCount += storeMask4(mask >> 4, &visible[base + 4], lanes - 4);
+        }
+    }
+#elif defined(FRUSTUM_CULLER_SSE)
+    //         
+    __m128 planes[Frustum::PLANE_COUNT][4];
+    for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+        for (int k = 0; k < 4; ++k) {
+            planes[p][k] = _mm_set1_ps(frustum.planes[p][k]);
+        }
+    }
+
+    for (size_t base = 0; base < count; base += 4) {
+        __m128 x = _mm_loadu_ps(&centerX[base]);
+        __m128 y = _mm_loadu_ps(&centerY[base]);
+        __m128 z = _mm_loadu_ps(&centerZ[base]);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radius[base]));
+
+        //  ,        
+        __m128 inside = _mm_cmpeq_ps(x, x);
+        for (const auto& plane : planes) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, plane[0]), _mm_mul_ps(y, plane[1])),
+                                  _mm_add_ps(_mm_mul_ps(z, plane[2]), plane[3]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+
+        visibleCount += storeMask4(_mm_movemask_ps(inside), &visible[base], count - base);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        bool inside = true;
+        for (const auto& plane : frustum.planes) {
+            float d = plane[0] * centerX[i] + plane[1] * centerY[i] + plane[2] * centerZ[i] + plane[3];
+            inside = inside && d >= -radius[i];
+        }
+        visible[i] = inside ? 1 : 0;
+        visibleCount += inside ? 1 : 0;
+    }
+#endif
+
+    stats.tested = count;
+    stats.culled = count - visibleCount;
+    return visibleCount;
+}
@@ -0,0 +1,256 @@
+#include "../include/GLStateCache.h"
+#include <algorithm>
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+size_t GLStateCache::Stats::totalIssued() const {
+    return programs.issued + vertexArrays.issued + textures.issued + buffers.issued + capabilities.issued;
+}
+
+size_t GLStateCache::Stats::totalSkipped() const {
+    return programs.skipped + vertexArrays.skipped + textures.skipped + buffers.skipped + capabilities.skipped;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+GLStateCache& GLStateCache::get() {
+    static GLStateCache instance;
+    return instance;
+}
+
+GLStateCache::GLStateCache() {
+    invalidate();
+}
+
+void GLStateCache::invalidate() {
+    program = UNKNOWN;
+    pipeline = UNKNOWN;
+    vertexArray = UNKNOWN;
+    activeUnit = UNKNOWN;
+    std::fill(std::begin(textures), std::end(textures), UNKNOWN);
+    std::fill(std::begin(uniformBindings), std::end(uniformBindings), IndexedBinding());
+    buffers.clear();
+    pipelineStages.clear();
+    capabilities.clear();
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void GLStateCache::useProgram(GLuint newProgram) {
+    if (program == newProgram) {
+        stats.programs.skipped++;
+        return;
+    }
+    glUseProgram(newProgram);
+    program = newProgram;
+    stats.programs.issued++;
+}
+
+void GLStateCache::bindProgramPipeline(GLuint newPipeline) {
+    if (pipeline == newPipeline) {
+        stats.programs.skipped++;
+        return;
+    }
+    glBindProgramPipeline(newPipeline);
+    pipeline = newPipeline;
+    stats.programs.issued++;
+}
+
+void GLStateCache::useProgramStages(GLuint targetPipeline, GLbitfield stages, GLuint stageProgram) {
+    //       
+    PipelineStages& current = pipelineStages[targetPipeline];
+    GLuint* slot = nullptr;
+    if (stages == GL_VERTEX_SHADER_BIT) {
+        slot = &current.vertex;
+    }
+    else if (stages == GL_FRAGMENT_SHADER_BIT) {
+        slot = &current.fragment;
+    }
+
+    if (slot && *slot == stageProgram) {
+        stats.programs.skipped++;
+        return;
+    }
+    glUseProgramStages(targetPipeline, stages, stageProgram);
+    if (slot) {
+        *slot = stageProgram;
+    }
+    else {
+        current = PipelineStages();
+    }
+    stats.programs.issued++;
+}
+
+// ----------------------------------------------------------------------
+//    
+// ----------------------------------------------------------------------
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (vertexArray == vao) {
+        stats.vertexArrays.skipped++;
+        return;
+    }
+    glBindVertexArray(vao);
+    vertexArray = vao;
+    stats.vertexArrays.issued++;
+}
+
+void GLStateCache::bindTexture(GLuint unit, GLuint texture, GLenum target) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        //   :  ,      
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        activeUnit = UNKNOWN;
+        stats.textures.issued += 2;
+        return;
+    }
+
+    if (textures[unit] == texture) {
+        stats.textures.skipped++;
+        return;
+    }
+
+    if (activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+        stats.textures.issued++;
+    }
+    glBindTexture(target, texture);
+    textures[unit] = texture;
+    stats.textures.issued++;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    auto it = buffers.find(target);
+    if (it != buffers.end() && it->second == buffer) {
+        stats.buffers.skipped++;
+        return;
+    }
+    glBindBuffer(target, buffer);
+    buffers[target] = buffer;
+    stats.buffers.issued++;
+}
+
+void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    bindBufferRange(target, index, buffer, 0, 0);
+}
+
+void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    bool tracked = target == GL_UNIFORM_BUFFER && index < MAX_BUFFER_BINDINGS;
+    if (tracked) {
+        const IndexedBinding& binding = uniformBindings[index];
+        if (binding.buffer == buffer && binding.offset == offset && binding.size == size) {
+            stats.buffers.skipped++;
+            return;
+        }
+    }
+
+    if (size == 0) {
+        glBindBufferBase(target, index, buffer);
+    }
+    else {
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+    stats.buffers.issued++;
+
+    if (tracked) {
+        uniformBindings[index] = { buffer, offset, size };
+    }
+    //         
+    buffers[target] = buffer;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void GLStateCache::enable(GLenum capability) {
+    setCapability(capability, true);
+}
+
+void GLStateCache::disable(GLenum capability) {
+    setCapability(capability, false);
+}
+
+void GLStateCache::setCapability(GLenum capability, bool enabled) {
+    auto it = std::find_if(capabilities.begin(), capabilities.end(),
+        [capability](const std::pair<GLenum, bool>& entry) { return entry.first == capability; });
+    if (it != capabilities.end() && it->second == enabled) {
+        stats.capabilities.skipped++;
+        return;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    }
+    else {
+        glDisable(capability);
+    }
+    stats.capabilities.issued++;
+
+    if (it != capabilities.end()) {
+        it->second = enabled;
+    }
+    else {
+        capabilities.emplace_back(capability, enabled);
+    }
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void GLStateCache::forgetProgram(GLuint deleted) {
+    //     ,    
+    if (program == deleted) {
+        program = UNKNOWN;
+    }
+    for (auto& entry : pipelineStages) {
+        if (entry.second.vertex == deleted) entry.second.vertex = UNKNOWN;
+        if (entry.second.fragment == deleted) entry.second.fragment = UNKNOWN;
+    }
+}
+
+void GLStateCache::forgetProgramPipeline(GLuint deleted) {
+    if (pipeline == deleted) {
+        pipeline = UNKNOWN;
+    }
+    pipelineStages.erase(deleted);
+}
+
+void GLStateCache::forgetVertexArray(GLuint deleted) {
+    if (vertexArray == deleted) {
+        vertexArray = UNKNOWN;
+    }
+}
+
+void GLStateCache::forgetTexture(GLuint deleted) {
+    for (GLuint& texture : textures) {
+        if (texture == deleted) {
+            texture = UNKNOWN;
+        }
+    }
+}
+
+void GLStateCache::forgetBuffer(GLuint deleted) {
+    for (auto& entry : buffers) {
+        if (entry.second == deleted) {
+            entry.second = UNKNOWN;
+        }
+    }
+    for (IndexedBinding& binding : uniformBindings) {
+        if (binding.buffer == deleted) {
+            binding = IndexedBinding();
+        }
+    }
+}
@@ -0,0 +1,215 @@
+#include "../include/ImpostorAtlas.h"
+#include "../include/GLStateCache.h"
+#include "../include/Shader.h"
+#include "../include/Texture.h"
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+ImpostorAtlas::ImpostorAtlas() {
+    glGenVertexArrays(1, &emptyVertexArray);
+
+    //       -    
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, ATLAS_SIZE, ATLAS_SIZE);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+}
+
+ImpostorAtlas::~ImpostorAtlas() {
+    GLStateCache& state = GLStateCache::get();
+    for (auto& entry : impostors) {
+        state.forgetTexture(entry.second.albedo);
+        state.forgetTexture(entry.second.normalDepth);
+        GLuint textures[2] = { entry.second.albedo, entry.second.normalDepth };
+        glDeleteTextures(2, textures);
+    }
+    state.forgetVertexArray(emptyVertexArray);
+    glDeleteVertexArrays(1, &emptyVertexArray);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+Vec3 ImpostorAtlas::frameDirection(int i, int j) {
+    //   ->   [-1, 1]^2 ->  ( +Y  , -Y -  )
+    float px = (i + 0.5f) / GRID * 2.0f - 1.0f;
+    float pz = (j + 0.5f) / GRID * 2.0f - 1.0f;
+    Vec3 direction(px, 1.0f - std::abs(px) - std::abs(pz), pz);
+    if (direction.y < 0.0f) {
+        direction.x = (1.0f - std::abs(pz)) * (px >= 0.0f ? 1.0f : -1.0f);
+        direction.z = (1.0f - std::abs(px)) * (pz >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    return direction / length;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+const ImpostorAtlas::Impostor& ImpostorAtlas::acquire(const Mesh& mesh, const Texture* texture, Shader& bakeShader) {
+    auto key = std::make_pair(&mesh, texture);
+    auto it = impostors.find(key);
+    if (it != impostors.end()) {
+        return it->second;
+    }
+
+    Impostor impostor;
+    const MeshBounds& bounds = mesh.getBounds();
+    impostor.bounds[0] = bounds.center.x;
+    impostor.bounds[1] = bounds.center.y;
+    impostor.bounds[2] = bounds.center.z;
+    impostor.bounds[3] = bounds.radius;
+
+    //    (   -);    - NEAREST,
+    //        
+    GLStateCache& state = GLStateCache::get();
+    GLuint textures[2];
+    glGenTextures(2, textures);
+    impostor.albedo = textures[0];
+    impostor.normalDepth = textures[1];
+
+    state.bindTexture(0, impostor.albedo);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    state.bindTexture(0, impostor.normalDepth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    try {
+        bake(mesh, texture, bakeShader, impostor);
+    }
+    catch (...) {
+        state.forgetTexture(impostor.albedo);
+        state.forgetTexture(impostor.normalDepth);
+        glDeleteTextures(2, textures);
+        throw;
+    }
+
+    stats.impostors++;
+    stats.textureBytes += static_cast<size_t>(ATLAS_SIZE) * ATLAS_SIZE * (4 + 8);
+    std::cout << "INFO::IMPOSTOR_ATLAS: Baked " << GRID << "x" << GRID << " impostor atlas (" << ATLAS_SIZE << "x"
+              << ATLAS_SIZE << ", " << mesh.indices.size() / 3 << " triangles per frame)." << std::endl;
+    return impostors.emplace(key, impostor).first->second;
+}
+
+void ImpostorAtlas::bake(const Mesh& mesh, const Texture* texture, Shader& bakeShader, Impostor& impostor) {
+    GLStateCache& state = GLStateCache::get();
+
+    //     :       
+    GLint previousFramebuffer = 0;
+    GLint previousViewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, impostor.albedo, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, impostor.normalDepth, 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+        throw std::runtime_error("ERROR::IMPOSTOR_ATLAS: Bake framebuffer is incomplete (status "
+                                 + std::to_string(status) + ").");
+    }
+
+    //  :   (  )
+    const GLfloat empty[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const GLfloat farDepth = 1.0f;
+    glViewport(0, 0, ATLAS_SIZE, ATLAS_SIZE);
+    glClearBufferfv(GL_COLOR, 0, empty);
+    glClearBufferfv(GL_COLOR, 1, empty);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+
+    state.enable(GL_DEPTH_TEST);
+    bakeShader.use();
+    const StandardUniforms& u = bakeShader.standardUniforms();
+    bakeShader.set(u.material.textureDiffuse, 0);
+    bakeShader.set(u.impostor.bakeTextured, texture != nullptr);
+    if (texture) {
+        texture->bind(0);
+    }
+
+    const float* center = impostor.bounds;
+    float radius = impostor.bounds[3] > 0.0f ? impostor.bounds[3] : 1.0f;
+
+    for (int j = 0; j < GRID; ++j) {
+        for (int i = 0; i < GRID; ++i) {
+            //   -  ,   impostor.vert: right = Y x d, up = d x right
+            Vec3 d = frameDirection(i, j);
+            Vec3 right(d.z, 0.0f, -d.x);
+            float rightLength = std::sqrt(right.x * right.x + right.z * right.z);
+            right = right / rightLength;
+            Vec3 up(d.y * right.z - d.z * right.y, d.z * right.x - d.x * right.z, d.x * right.y - d.y * right.x);
+
+            //       : x - right, y - up,
+            //     ,     (z = -1),   (z = 1)
+            auto dot = [center](const Vec3& axis) {
+                return axis.x * center[0] + axis.y * center[1] + axis.z * center[2];
+            };
+            float viewProjection[16] = {
+                right.x / radius, up.x / radius, -d.x / radius, 0.0f,
+                right.y / radius, up.y / radius, -d.y / radius, 0.0f,
+                right.z / radius, up.z / radius, -d.z / radius, 0.0f,
+                -dot(right) / radius, -dot(up) / radius, dot(d) / radius, 1.0f
+            };
+            bakeShader.set(u.impostor.bakeViewProjection, viewProjection);
+
+            glViewport(i * FRAME_SIZE, j * FRAME_SIZE, FRAME_SIZE, FRAME_SIZE);
+            mesh.draw();
+            stats.bakeDrawCalls++;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+const ImpostorAtlas::Impostor* ImpostorAtlas::find(const Mesh& mesh, const Texture* texture) const {
+    auto it = impostors.find(std::make_pair(&mesh, texture));
+    return it != impostors.end() ? &it->second : nullptr;
+}
+
+void ImpostorAtlas::bind(const Impostor& impostor) const {
+    GLStateCache& state = GLStateCache::get();
+    state.bindTexture(ALBEDO_UNIT, impostor.albedo);
+    state.bindTexture(NORMAL_DEPTH_UNIT, impostor.normalDepth);
+}
+
+void ImpostorAtlas::drawBillboards(int count) const {
+    if (count <= 0) {
+        return;
+    }
+    GLStateCache::get().bindVertexArray(emptyVertexArray);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+}
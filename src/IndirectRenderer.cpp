@@ -0,0 +1,215 @@
+#include "../include/IndirectRenderer.h"
+#include "../include/GLStateCache.h"
+#include "../include/Shader.h"
+#include "../include/Texture.h"
+#include <cstring>
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+bool IndirectRenderer::isSupported() {
+    //   - GLSL 4.30 (SSBO,  ); gl_DrawIDARB -  ARB_shader_draw_parameters
+    return GLEW_VERSION_4_3 && GLEW_ARB_shader_draw_parameters;
+}
+
+IndirectRenderer::IndirectRenderer() {
+    GLuint buffers[5];
+    glGenBuffers(5, buffers);
+    vertexBuffer = buffers[0];
+    indexBuffer = buffers[1];
+    objectBuffer = buffers[2];
+    meshBuffer = buffers[3];
+    commandBuffer = buffers[4];
+    glGenVertexArrays(1, &vertexArray);
+
+    //    ,   Mesh::setupMesh;     uploadGeometry
+    GLStateCache& state = GLStateCache::get();
+    state.bindVertexArray(vertexArray);
+    state.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer); //   VAO,    
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+
+    state.bindVertexArray(0);
+}
+
+IndirectRenderer::~IndirectRenderer() {
+    GLStateCache& state = GLStateCache::get();
+    state.forgetVertexArray(vertexArray);
+    for (GLuint buffer : { vertexBuffer, indexBuffer, objectBuffer, meshBuffer, commandBuffer }) {
+        state.forgetBuffer(buffer);
+    }
+
+    GLuint buffers[5] = { vertexBuffer, indexBuffer, objectBuffer, meshBuffer, commandBuffer };
+    glDeleteBuffers(5, buffers);
+    glDeleteVertexArrays(1, &vertexArray);
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void IndirectRenderer::beginFrame() {
+    objects.clear();
+    batches.clear();
+    stats.objects = 0;
+    stats.multiDrawCalls = 0;
+}
+
+void IndirectRenderer::addObject(const Mesh& mesh, const Texture* texture, const float* model,
+                                 int materialIndex, int culledLights) {
+    if (mesh.indices.empty()) {
+        return;
+    }
+
+    const MeshBounds& bounds = mesh.getBounds();
+    ObjectRecord record;
+    std::memcpy(record.model, model, sizeof(record.model));
+    record.boundingSphere[0] = bounds.center.x;
+    record.boundingSphere[1] = bounds.center.y;
+    record.boundingSphere[2] = bounds.center.z;
+    record.boundingSphere[3] = bounds.radius;
+    record.meshIndex = acquireMesh(mesh);
+    record.materialIndex = materialIndex;
+    record.culledLights = culledLights;
+    record.pad = 0;
+
+    //        :  ,    
+    GLsizei slot = static_cast<GLsizei>(objects.size());
+    objects.push_back(record);
+    if (batches.empty() || batches.back().texture != texture) {
+        batches.push_back({ texture, slot, 0 });
+    }
+    batches.back().count++;
+}
+
+uint32_t IndirectRenderer::acquireMesh(const Mesh& mesh) {
+    auto it = meshIndices.find(&mesh);
+    if (it != meshIndices.end()) {
+        return it->second;
+    }
+
+    //    : baseVertex      
+    MeshRecord record;
+    record.firstIndex = static_cast<uint32_t>(indexCount);
+    record.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    record.baseVertex = static_cast<int32_t>(vertexCount);
+    record.pad = 0;
+
+    uint32_t index = static_cast<uint32_t>(meshes.size());
+    meshes.push_back(&mesh);
+    meshIndices[&mesh] = index;
+    meshRecords.push_back(record);
+    vertexCount += mesh.vertices.size();
+    indexCount += mesh.indices.size();
+    geometryDirty = true;
+    return index;
+}
+
+void IndirectRenderer::clearGeometry() {
+    meshes.clear();
+    meshIndices.clear();
+    meshRecords.clear();
+    vertexCount = 0;
+    indexCount = 0;
+    geometryDirty = true;
+}
+
+void IndirectRenderer::uploadGeometry() {
+    //    ( ):   ,  CPU-  
+    GLStateCache& state = GLStateCache::get();
+    state.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+
+    //   -   VAO:    
+    state.bindVertexArray(vertexArray);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const Mesh& mesh = *meshes[i];
+        const MeshRecord& record = meshRecords[i];
+        glBufferSubData(GL_ARRAY_BUFFER, record.baseVertex * sizeof(Vertex), mesh.vertices.size() * sizeof(Vertex),
+                        mesh.vertices.data());
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, record.firstIndex * sizeof(unsigned int),
+                        mesh.indices.size() * sizeof(unsigned int), mesh.indices.data());
+    }
+
+    state.bindBuffer(GL_SHADER_STORAGE_BUFFER, meshBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, meshRecords.size() * sizeof(MeshRecord), meshRecords.data(), GL_STATIC_DRAW);
+
+    stats.meshes = meshes.size();
+    stats.geometryBytes = vertexCount * sizeof(Vertex) + indexCount * sizeof(unsigned int);
+    geometryDirty = false;
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+void IndirectRenderer::cull(Shader& cullShader, const Frustum& frustum) {
+    stats.objects = objects.size();
+    if (objects.empty()) {
+        return;
+    }
+    if (geometryDirty) {
+        uploadGeometry();
+    }
+
+    GLStateCache& state = GLStateCache::get();
+
+    //  :   (orphaning),    ,    
+    state.bindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(ObjectRecord), objects.data(), GL_STREAM_DRAW);
+
+    //    GPU:  ,     
+    GLsizeiptr commandBytes = static_cast<GLsizeiptr>(objects.size() * sizeof(DrawElementsIndirectCommand));
+    if (commandBytes > commandCapacity) {
+        state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commandBytes, nullptr, GL_DYNAMIC_COPY);
+        commandCapacity = commandBytes;
+    }
+
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_STORAGE_BINDING, objectBuffer);
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_STORAGE_BINDING, meshBuffer);
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_COMMAND_STORAGE_BINDING, commandBuffer);
+
+    cullShader.use();
+    const IndirectDrawUniforms& u = cullShader.standardUniforms().indirect;
+    cullShader.setArray(u.frustumPlanes, &frustum.planes[0][0], Frustum::PLANE_COUNT);
+    cullShader.set(u.objectCount, static_cast<int>(objects.size()));
+
+    GLuint groups = (static_cast<GLuint>(objects.size()) + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+    glDispatchCompute(groups, 1, 1);
+
+    //     glMultiDrawElementsIndirect -       
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+}
+
+void IndirectRenderer::draw(const Shader& drawShader) {
+    if (objects.empty()) {
+        return;
+    }
+
+    GLStateCache& state = GLStateCache::get();
+    state.bindVertexArray(vertexArray);
+    state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_STORAGE_BINDING, objectBuffer);
+
+    const Uniform<int> drawBase = drawShader.standardUniforms().indirect.drawBase;
+    for (const Batch& batch : batches) {
+        if (batch.texture) {
+            batch.texture->bind(0);
+        }
+        drawShader.set(drawBase, batch.first);
+
+        const void* offset = reinterpret_cast<const void*>(batch.first * sizeof(DrawElementsIndirectCommand));
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, batch.count, sizeof(DrawElementsIndirectCommand));
+        stats.multiDrawCalls++;
+    }
+}
@@ -0,0 +1,425 @@
+#include "../include/LightClusters.h"
+#include "../include/GLStateCache.h"
+#include "../include/Shader.h"
+#include "../include/Light/PointLight.h"
+#include "../include/Light/SpotLight.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LIGHT_CLUSTERS_SSE
+#endif
+
+static_assert(LightClusters::GRID_X % 4 == 0, "Cluster row must be a multiple of the SIMD width");
+
+//      (TEXELS_PER_LIGHT x RGBA32F,  ):
+//   0: position.xyz,  (0 - , 1 - )
+//   1: color.rgb, constant
+//   2: direction.xyz, linear
+//   3: quadratic, cutOff, outerCutOff, 0
+//   fetchPointLight / fetchSpotLight  phong, toon, custom, uber  deferred.frag.
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+LightClusters::LightClusters() {
+    GLStateCache& state = GLStateCache::get();
+
+    GLuint buffers[3];
+    GLuint textures[3];
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+    lightBuffer = buffers[0];
+    rangeBuffer = buffers[1];
+    indexBuffer = buffers[2];
+    lightTexture = textures[0];
+    rangeTexture = textures[1];
+    indexTexture = textures[2];
+
+    //      ,     build()   
+    const std::pair<GLuint, GLenum> formats[3] = { { lightBuffer, GL_RGBA32F }, { rangeBuffer, GL_RG32UI }, { indexBuffer, GL_R32UI } };
+    const GLuint units[3] = { LIGHTS_UNIT, RANGES_UNIT, INDICES_UNIT };
+    for (int i = 0; i < 3; ++i) {
+        state.bindBuffer(GL_TEXTURE_BUFFER, formats[i].first);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        state.bindTexture(units[i], textures[i], GL_TEXTURE_BUFFER);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i].second, formats[i].first);
+    }
+
+    glGenBuffers(1, &uniformBuffer);
+    state.bindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(ClusterBlock), nullptr, GL_DYNAMIC_DRAW);
+    state.bindBufferBase(GL_UNIFORM_BUFFER, CLUSTER_BLOCK_BINDING, uniformBuffer);
+
+    ranges.assign(CLUSTER_COUNT * 2, 0);
+
+    //    65536 ;    (. build)
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    maxReferences = static_cast<size_t>(std::max(maxTexels, 65536));
+}
+
+LightClusters::~LightClusters() {
+    GLStateCache& state = GLStateCache::get();
+    for (GLuint texture : { lightTexture, rangeTexture, indexTexture }) {
+        state.forgetTexture(texture);
+    }
+    for (GLuint buffer : { lightBuffer, rangeBuffer, indexBuffer, uniformBuffer }) {
+        state.forgetBuffer(buffer);
+    }
+
+    GLuint textures[3] = { lightTexture, rangeTexture, indexTexture };
+    GLuint buffers[4] = { lightBuffer, rangeBuffer, indexBuffer, uniformBuffer };
+    glDeleteTextures(3, textures);
+    glDeleteBuffers(4, buffers);
+}
+
+const char* LightClusters::instructionSet() {
+#if defined(LIGHT_CLUSTERS_SSE)
+    return "SSE, 4 clusters per test";
+#else
+    return "scalar";
+#endif
+}
+
+float LightClusters::lightRange(const Vec3& color, float constant, float linear, float quadratic) {
+    //    color * 1 / (c + l*d + q*d^2);  d,    
+    float brightest = std::max({ color.x, color.y, color.z });
+    if (brightest <= 0.0f) {
+        return 0.0f;
+    }
+
+    float k = brightest / ATTENUATION_CUTOFF;
+    if (constant >= k) {
+        return 0.0f;
+    }
+    if (quadratic > 0.0f) {
+        return (-linear + std::sqrt(linear * linear + 4.0f * quadratic * (k - constant))) / (2.0f * quadratic);
+    }
+    if (linear > 0.0f) {
+        return (k - constant) / linear;
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void LightClusters::updateClusterBounds(const Camera& camera) {
+    if (camera.Zoom == boundsFov && camera.aspectRatio == boundsAspect
+        && camera.nearPlane == boundsNear && camera.farPlane == boundsFar) {
+        return;
+    }
+    boundsFov = camera.Zoom;
+    boundsAspect = camera.aspectRatio;
+    boundsNear = camera.nearPlane;
+    boundsFar = camera.farPlane;
+
+    for (auto* bounds : { &boundsMinX, &boundsMinY, &boundsMinZ, &boundsMaxX, &boundsMaxY, &boundsMaxZ,
+                          &sphereX, &sphereY, &sphereZ, &sphereRadius }) {
+        bounds->resize(CLUSTER_COUNT);
+    }
+
+    const float tanY = std::tan(camera.Zoom * 3.14159265f / 360.0f);
+    const float tanX = tanY * camera.aspectRatio;
+    const float depthRatio = camera.farPlane / camera.nearPlane;
+
+    for (int z = 0; z < GRID_Z; ++z) {
+        //  :         
+        float nearDepth = camera.nearPlane * std::pow(depthRatio, static_cast<float>(z) / GRID_Z);
+        float farDepth = camera.nearPlane * std::pow(depthRatio, static_cast<float>(z + 1) / GRID_Z);
+
+        for (int y = 0; y < GRID_Y; ++y) {
+            float ndcY0 = -1.0f + 2.0f * y / GRID_Y;
+            float ndcY1 = -1.0f + 2.0f * (y + 1) / GRID_Y;
+
+            for (int x = 0; x < GRID_X; ++x) {
+                float ndcX0 = -1.0f + 2.0f * x / GRID_X;
+                float ndcX1 = -1.0f + 2.0f * (x + 1) / GRID_X;
+
+                //  -  ;  AABB -        
+                float minX = std::min({ ndcX0 * tanX * nearDepth, ndcX0 * tanX * farDepth });
+                float maxX = std::max({ ndcX1 * tanX * nearDepth, ndcX1 * tanX * farDepth });
+                float minY = std::min({ ndcY0 * tanY * nearDepth, ndcY0 * tanY * farDepth });
+                float maxY = std::max({ ndcY1 * tanY * nearDepth, ndcY1 * tanY * farDepth });
+
+                size_t i = (static_cast<size_t>(z) * GRID_Y + y) * GRID_X + x;
+                boundsMinX[i] = minX;
+                boundsMaxX[i] = maxX;
+                boundsMinY[i] = minY;
+                boundsMaxY[i] = maxY;
+                boundsMinZ[i] = -farDepth;
+                boundsMaxZ[i] = -nearDepth;
+
+                sphereX[i] = 0.5f * (minX + maxX);
+                sphereY[i] = 0.5f * (minY + maxY);
+                sphereZ[i] = -0.5f * (nearDepth + farDepth);
+                float hx = 0.5f * (maxX - minX), hy = 0.5f * (maxY - minY), hz = 0.5f * (farDepth - nearDepth);
+                sphereRadius[i] = std::sqrt(hx * hx + hy * hy + hz * hz);
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void LightClusters::build(const Camera& camera, const float* view, const std::vector<std::shared_ptr<Light>>& lights,
+                          int viewportWidth, int viewportHeight) {
+    auto start = std::chrono::steady_clock::now();
+    updateClusterBounds(camera);
+
+    binned.clear();
+    lightTexels.clear();
+    referenceCluster.clear();
+    referenceLight.clear();
+    stats = Stats();
+
+    auto toView = [view](const Vec3& p, float w, float out[3]) {
+        for (int k = 0; k < 3; ++k) {
+            out[k] = view[k] * p.x + view[4 + k] * p.y + view[8 + k] * p.z + view[12 + k] * w;
+        }
+    };
+
+    for (const auto& light : lights) {
+        BinnedLight entry{};
+        float texels[TEXELS_PER_LIGHT * 4] = {};
+
+        if (auto point = std::dynamic_pointer_cast<PointLight>(light)) {
+            entry.range = lightRange(point->color, point->constant, point->linear, point->quadratic);
+            toView(point->position, 1.0f, entry.center);
+            entry.radius = entry.range;
+
+            float data[] = { point->position.x, point->position.y, point->position.z, 0.0f,
+                             point->color.x, point->color.y, point->color.z, point->constant,
+                             0.0f, 0.0f, 0.0f, point->linear,
+                             point->quadratic, 0.0f, 0.0f, 0.0f };
+            std::copy(std::begin(data), std::end(data), texels);
+            stats.pointLights++;
+        }
+        else if (auto spot = std::dynamic_pointer_cast<SpotLight>(light)) {
+            entry.spot = true;
+            entry.range = lightRange(spot->color, spot->constant, spot->linear, spot->quadratic);
+            toView(spot->position, 1.0f, entry.apex);
+            toView(spot->direction, 0.0f, entry.axis);
+            float axisLength = std::sqrt(entry.axis[0] * entry.axis[0] + entry.axis[1] * entry.axis[1] + entry.axis[2] * entry.axis[2]);
+            for (float& component : entry.axis) {
+                component = axisLength > 0.0f ? component / axisLength : 0.0f;
+            }
+            entry.cosAngle = std::clamp(spot->outerCutOff, -1.0f, 1.0f);
+            entry.sinAngle = std::sqrt(1.0f - entry.cosAngle * entry.cosAngle);
+
+            //   :    -      
+            if (entry.cosAngle > 0.5f && std::isfinite(entry.range)) {
+                float radius = entry.range / (2.0f * entry.cosAngle);
+                for (int k = 0; k < 3; ++k) {
+                    entry.center[k] = entry.apex[k] + entry.axis[k] * radius;
+                }
+                entry.radius = radius;
+            }
+            else {
+                std::copy(entry.apex, entry.apex + 3, entry.center);
+                entry.radius = entry.range;
+            }
+
+            float data[] = { spot->position.x, spot->position.y, spot->position.z, 1.0f,
+                             spot->color.x, spot->color.y, spot->color.z, spot->constant,
+                             spot->direction.x, spot->direction.y, spot->direction.z, spot->linear,
+                             spot->quadratic, spot->cutOff, spot->outerCutOff, 0.0f };
+            std::copy(std::begin(data), std::end(data), texels);
+            stats.spotLights++;
+        }
+        else {
+            continue;
+        }
+
+        if (entry.range <= 0.0f) {
+            continue;
+        }
+
+        uint32_t lightIndex = static_cast<uint32_t>(binned.size());
+        binned.push_back(entry);
+        lightTexels.insert(lightTexels.end(), std::begin(texels), std::end(texels));
+        binLight(entry, lightIndex);
+    }
+
+    if (referenceCluster.size() > maxReferences) {
+        if (!overflowReported) {
+            std::cerr << "WARNING::LIGHT_CLUSTERS: " << referenceCluster.size() << " light references exceed the texture buffer limit ("
+                      << maxReferences << "), the rest are dropped." << std::endl;
+            overflowReported = true;
+        }
+        referenceCluster.resize(maxReferences);
+        referenceLight.resize(maxReferences);
+    }
+
+    //  :   ,    -   
+    // (      )
+    uint32_t listLimit = maxLightsPerCluster > 0 ? static_cast<uint32_t>(maxLightsPerCluster) : std::numeric_limits<uint32_t>::max();
+    std::fill(ranges.begin(), ranges.end(), 0u);
+    for (uint32_t cluster : referenceCluster) {
+        ranges[cluster * 2 + 1]++;
+    }
+    uint32_t offset = 0;
+    for (int cluster = 0; cluster < CLUSTER_COUNT; ++cluster) {
+        uint32_t count = std::min(ranges[cluster * 2 + 1], listLimit);
+        ranges[cluster * 2] = offset;
+        offset += count;
+        stats.maxPerCluster = std::max<size_t>(stats.maxPerCluster, count);
+        stats.occupiedClusters += count > 0 ? 1 : 0;
+        ranges[cluster * 2 + 1] = 0;
+    }
+    indices.resize(offset);
+    for (size_t k = 0; k < referenceCluster.size(); ++k) {
+        uint32_t* range = &ranges[referenceCluster[k] * 2];
+        if (range[1] < listLimit) {
+            indices[range[0] + range[1]++] = referenceLight[k];
+        }
+    }
+    stats.references = indices.size();
+
+    upload(camera, viewportWidth, viewportHeight);
+    stats.buildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LightClusters::binLight(const BinnedLight& light, uint32_t lightIndex) {
+    //  ,    (  )
+    float depthNear = -light.center[2] - light.radius;
+    float depthFar = -light.center[2] + light.radius;
+    if (depthFar < boundsNear || depthNear > boundsFar) {
+        return;
+    }
+
+    const float sliceScale = GRID_Z / std::log(boundsFar / boundsNear);
+    int slice0 = depthNear <= boundsNear ? 0 : static_cast<int>(std::log(depthNear / boundsNear) * sliceScale);
+    int slice1 = depthFar >= boundsFar ? GRID_Z - 1 : static_cast<int>(std::log(depthFar / boundsNear) * sliceScale);
+    slice0 = std::clamp(slice0, 0, GRID_Z - 1);
+    slice1 = std::clamp(slice1, 0, GRID_Z - 1);
+
+    const float radiusSq = light.radius * light.radius;
+
+    auto emit = [&](size_t base, int mask) {
+        for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+            if (mask & 1) {
+                referenceCluster.push_back(static_cast<uint32_t>(base + lane));
+                referenceLight.push_back(lightIndex);
+            }
+        }
+    };
+
+#if defined(LIGHT_CLUSTERS_SSE)
+    const __m128 cx = _mm_set1_ps(light.center[0]);
+    const __m128 cy = _mm_set1_ps(light.center[1]);
+    const __m128 cz = _mm_set1_ps(light.center[2]);
+    const __m128 r2 = _mm_set1_ps(radiusSq);
+    const __m128 zero = _mm_setzero_ps();
+
+    const __m128 ax = _mm_set1_ps(light.apex[0]), ay = _mm_set1_ps(light.apex[1]), az = _mm_set1_ps(light.apex[2]);
+    const __m128 dx = _mm_set1_ps(light.axis[0]), dy = _mm_set1_ps(light.axis[1]), dz = _mm_set1_ps(light.axis[2]);
+    const __m128 cosA = _mm_set1_ps(light.cosAngle), sinA = _mm_set1_ps(light.sinAngle);
+    const __m128 range = _mm_set1_ps(light.range);
+
+    for (int z = slice0; z <= slice1; ++z) {
+        for (int y = 0; y < GRID_Y; ++y) {
+            size_t row = (static_cast<size_t>(z) * GRID_Y + y) * GRID_X;
+            for (int x = 0; x < GRID_X; x += 4) {
+                size_t i = row + x;
+
+                //   AABB:        
+                __m128 ex = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boundsMinX[i]), cx), _mm_sub_ps(cx, _mm_loadu_ps(&boundsMaxX[i]))), zero);
+                __m128 ey = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boundsMinY[i]), cy), _mm_sub_ps(cy, _mm_loadu_ps(&boundsMaxY[i]))), zero);
+                __m128 ez = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boundsMinZ[i]), cz), _mm_sub_ps(cz, _mm_loadu_ps(&boundsMaxZ[i]))), zero);
+                __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), _mm_mul_ps(ez, ez));
+                __m128 hit = _mm_cmple_ps(distanceSq, r2);
+
+                if (light.spot && _mm_movemask_ps(hit) != 0) {
+                    //    :     ,     
+                    __m128 sr = _mm_loadu_ps(&sphereRadius[i]);
+                    __m128 vx = _mm_sub_ps(_mm_loadu_ps(&sphereX[i]), ax);
+                    __m128 vy = _mm_sub_ps(_mm_loadu_ps(&sphereY[i]), ay);
+                    __m128 vz = _mm_sub_ps(_mm_loadu_ps(&sphereZ[i]), az);
+                    __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+                    __m128 along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, dx), _mm_mul_ps(vy, dy)), _mm_mul_ps(vz, dz));
+                    __m128 across = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(lengthSq, _mm_mul_ps(along, along)), zero));
+                    __m128 closest = _mm_sub_ps(_mm_mul_ps(cosA, across), _mm_mul_ps(along, sinA));
+                    __m128 outside = _mm_or_ps(_mm_or_ps(_mm_cmpgt_ps(closest, sr), _mm_cmpgt_ps(along, _mm_add_ps(sr, range))),
+                                               _mm_cmplt_ps(along, _mm_sub_ps(zero, sr)));
+                    hit = _mm_andnot_ps(outside, hit);
+                }
+
+                emit(i, _mm_movemask_ps(hit));
+            }
+        }
+    }
+#else
+    for (int z = slice0; z <= slice1; ++z) {
+        for (int y = 0; y < GRID_Y; ++y) {
+            size_t row = (static_cast<size_t>(z) * GRID_Y + y) * GRID_X;
+            for (int x = 0; x < GRID_X; ++x) {
+                size_t i = row + x;
+                float ex = std::max({ boundsMinX[i] - light.center[0], light.center[0] - boundsMaxX[i], 0.0f });
+                float ey = std::max({ boundsMinY[i] - light.center[1], light.center[1] - boundsMaxY[i], 0.0f });
+                float ez = std::max({ boundsMinZ[i] - light.center[2], light.center[2] - boundsMaxZ[i], 0.0f });
+                bool hit = ex * ex + ey * ey + ez * ez <= radiusSq;
+
+                if (light.spot && hit) {
+                    float vx = sphereX[i] - light.apex[0], vy = sphereY[i] - light.apex[1], vz = sphereZ[i] - light.apex[2];
+                    float along = vx * light.axis[0] + vy * light.axis[1] + vz * light.axis[2];
+                    float across = std::sqrt(std::max(vx * vx + vy * vy + vz * vz - along * along, 0.0f));
+                    float closest = light.cosAngle * across - along * light.sinAngle;
+                    hit = !(closest > sphereRadius[i] || along > sphereRadius[i] + light.range || along < -sphereRadius[i]);
+                }
+
+                emit(i, hit ? 1 : 0);
+            }
+        }
+    }
+#endif
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void LightClusters::upload(const Camera& camera, int viewportWidth, int viewportHeight) {
+    GLStateCache& state = GLStateCache::get();
+
+    //     ,  glBufferData       
+    auto orphan = [&state](GLuint buffer, const void* data, size_t bytes) {
+        state.bindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(std::max<size_t>(bytes, 16)), bytes > 0 ? data : nullptr, GL_STREAM_DRAW);
+    };
+    orphan(lightBuffer, lightTexels.data(), lightTexels.size() * sizeof(float));
+    orphan(rangeBuffer, ranges.data(), ranges.size() * sizeof(uint32_t));
+    orphan(indexBuffer, indices.data(), indices.size() * sizeof(uint32_t));
+
+    //      (gl_FragCoord),      
+    float depthRatioLog = std::log(camera.farPlane / camera.nearPlane);
+    ClusterBlock block{};
+    block.grid[0] = GRID_X;
+    block.grid[1] = GRID_Y;
+    block.grid[2] = GRID_Z;
+    block.tileSize[0] = static_cast<float>(viewportWidth) / GRID_X;
+    block.tileSize[1] = static_cast<float>(viewportHeight) / GRID_Y;
+    block.depthSlice[0] = camera.nearPlane;
+    block.depthSlice[1] = camera.farPlane;
+    block.depthSlice[2] = GRID_Z / depthRatioLog;
+    block.depthSlice[3] = -GRID_Z * std::log(camera.nearPlane) / depthRatioLog;
+
+    state.bindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ClusterBlock), &block);
+}
+
+void LightClusters::bind() const {
+    GLStateCache& state = GLStateCache::get();
+    state.bindTexture(LIGHTS_UNIT, lightTexture, GL_TEXTURE_BUFFER);
+    state.bindTexture(RANGES_UNIT, rangeTexture, GL_TEXTURE_BUFFER);
+    state.bindTexture(INDICES_UNIT, indexTexture, GL_TEXTURE_BUFFER);
+}
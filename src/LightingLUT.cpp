@@ -0,0 +1,110 @@
+#include "../include/LightingLUT.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+//  toon-  : , , 
+static const std::vector<float> DEFAULT_TOON_LEVELS = { 0.1f, 0.4f, 0.9f };
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+LightingLUT::LightingLUT(const std::string& toonRampPath) {
+    std::vector<float> orenNayar = bakeOrenNayar(OREN_NAYAR_SIZE);
+    orenNayarTexture = std::make_unique<Texture>(OREN_NAYAR_SIZE, OREN_NAYAR_SIZE, GL_R16F, GL_RED, orenNayar.data());
+
+    if (toonRampPath.empty() || !loadToonRamp(toonRampPath)) {
+        std::vector<float> ramp = bakeToonRamp(DEFAULT_TOON_LEVELS, TOON_RAMP_SIZE);
+        //     :     
+        toonRampTexture = std::make_unique<Texture>(TOON_RAMP_SIZE, 1, GL_R8, GL_RED, ramp.data(), GL_NEAREST);
+    }
+
+    std::cout << "INFO::LIGHTING_LUT: Baked Oren-Nayar table (" << OREN_NAYAR_SIZE << "x" << OREN_NAYAR_SIZE
+              << ") and toon ramp." << std::endl;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+std::vector<float> LightingLUT::bakeOrenNayar(int size) {
+    std::vector<float> table(static_cast<size_t>(size) * size);
+
+    for (int y = 0; y < size; ++y) {
+        //      - ,      
+        float cosR = ((y + 0.5f) / size) * 2.0f - 1.0f;
+        float sinR = std::sqrt(std::max(0.0f, 1.0f - cosR * cosR));
+
+        for (int x = 0; x < size; ++x) {
+            float cosI = (x + 0.5f) / size;
+            float sinI = std::sqrt(std::max(0.0f, 1.0f - cosI * cosI));
+
+            // alpha -    theta_i, theta_r (    custom.frag),
+            //  max(0, cos_i) * sin(alpha) * tan(alpha)      
+            float numerator;
+            float denominator;
+            if (cosI > cosR) {
+                numerator = sinI * sinI;
+                denominator = sinI * sinR;
+            }
+            else {
+                numerator = cosI * sinR * sinR;
+                denominator = cosR * sinI * sinR;
+            }
+
+            float value = numerator / std::max(denominator, 1e-4f);
+            table[static_cast<size_t>(y) * size + x] = std::clamp(value, 0.0f, OREN_NAYAR_MAX);
+        }
+    }
+    return table;
+}
+
+std::vector<float> LightingLUT::bakeToonRamp(const std::vector<float>& levels, int size) {
+    std::vector<float> ramp(size, levels.empty() ? 0.0f : levels.front());
+
+    for (int x = 0; x < size; ++x) {
+        float intensity = (x + 0.5f) / size;
+        for (float level : levels) {
+            if (intensity > level) {
+                ramp[x] = level;
+            }
+        }
+    }
+    return ramp;
+}
+
+bool LightingLUT::loadToonRamp(const std::string& path) {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+
+    sf::Image image;
+    if (!image.loadFromFile(path) || image.getSize().x == 0) {
+        std::cerr << "WARNING::LIGHTING_LUT: Could not read toon ramp, using default levels: " << path << std::endl;
+        return false;
+    }
+
+    //    ,  R (RGBA, 4   )
+    int width = static_cast<int>(image.getSize().x);
+    const unsigned char* pixels = image.getPixelsPtr();
+    std::vector<float> ramp(width);
+    for (int x = 0; x < width; ++x) {
+        ramp[x] = pixels[x * 4] / 255.0f;
+    }
+
+    toonRampTexture = std::make_unique<Texture>(width, 1, GL_R8, GL_RED, ramp.data(), GL_NEAREST);
+    std::cout << "INFO::LIGHTING_LUT: Loaded toon ramp: " << path << std::endl;
+    return true;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void LightingLUT::bind() const {
+    orenNayarTexture->bind(OREN_NAYAR_UNIT);
+    toonRampTexture->bind(TOON_RAMP_UNIT);
+}
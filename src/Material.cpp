@@ -13,11 +13,7 @@ Material::Material(const Vec3& ambient, const Vec3& diffuse, const Vec3& specula
     texture(texturePtr),
     model(lightingModel)
 {
-    //     
-    if (!texture) {
-        std::cerr << "WARNING::MATERIAL: Texture pointer is null." << std::endl;
-        //   / -   
-    }
+    //    :        (NO_TEXTURE)
 }
 
 // ----------------------------------------------------------------------
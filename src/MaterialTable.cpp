@@ -0,0 +1,105 @@
+#include "../include/MaterialTable.h"
+#include "../include/GLStateCache.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static_assert(sizeof(MaterialTable::EntryBlock) == 48, "MaterialEntry std140 size mismatch");
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+MaterialTable::MaterialTable() {
+    //    (  ),     
+    glGenBuffers(1, &bufferID);
+    GLStateCache& state = GLStateCache::get();
+    state.bindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(EntryBlock) * MAX_MATERIALS, nullptr, GL_DYNAMIC_DRAW);
+
+    state.bindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, bufferID);
+}
+
+MaterialTable::~MaterialTable() {
+    if (bufferID != 0) {
+        GLStateCache::get().forgetBuffer(bufferID);
+        glDeleteBuffers(1, &bufferID);
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+int MaterialTable::registerMaterial(const Material& material) {
+    auto it = indices.find(&material);
+    if (it != indices.end()) {
+        return it->second;
+    }
+
+    if (materials.size() >= (size_t)MAX_MATERIALS) {
+        std::cerr << "WARNING::MATERIAL_TABLE: More than " << MAX_MATERIALS
+                  << " unique materials, table is full." << std::endl;
+        return -1;
+    }
+
+    int index = (int)materials.size();
+    materials.push_back(&material);
+    uploaded.push_back(EntryBlock{});
+    indices[&material] = index;
+    return index;
+}
+
+int MaterialTable::indexOf(const Material& material) const {
+    auto it = indices.find(&material);
+    return it != indices.end() ? it->second : -1;
+}
+
+MaterialTable::EntryBlock MaterialTable::makeEntry(const Material& material) {
+    EntryBlock entry{};
+    entry.ambient[0] = material.ambient.x;
+    entry.ambient[1] = material.ambient.y;
+    entry.ambient[2] = material.ambient.z;
+    entry.shininess = material.shininess;
+    entry.diffuse[0] = material.diffuse.x;
+    entry.diffuse[1] = material.diffuse.y;
+    entry.diffuse[2] = material.diffuse.z;
+    entry.lightingModel = static_cast<int>(material.getLightingModel());
+    entry.specular[0] = material.specular.x;
+    entry.specular[1] = material.specular.y;
+    entry.specular[2] = material.specular.z;
+    entry.textured = material.hasTexture() ? 1 : 0;
+    return entry;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void MaterialTable::sync() {
+    //   :     
+    size_t first = materials.size();
+    size_t last = 0;
+
+    for (size_t i = 0; i < materials.size(); ++i) {
+        EntryBlock entry = makeEntry(*materials[i]);
+        if (i < uploadedCount && std::memcmp(&entry, &uploaded[i], sizeof(EntryBlock)) == 0) {
+            continue;
+        }
+        uploaded[i] = entry;
+        first = std::min(first, i);
+        last = i;
+    }
+
+    if (first >= materials.size()) {
+        return;
+    }
+
+    GLStateCache::get().bindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    glBufferSubData(GL_UNIFORM_BUFFER, first * sizeof(EntryBlock), (last - first + 1) * sizeof(EntryBlock),
+                    &uploaded[first]);
+
+    uploadedCount = materials.size();
+    stats.uploads++;
+    stats.uploadedEntries += last - first + 1;
+}
@@ -1,4 +1,5 @@
 #include "../include/Mesh.h"
+#include "../include/GLStateCache.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -7,8 +8,9 @@
 // ----------------------------------------------------------------------
 
 Mesh::Mesh(const std::vector<Vertex>& vertices,
-    const std::vector<unsigned int>& indices)
-    : vertices(vertices), indices(indices), VAO(0), VBO(0), EBO(0)
+    const std::vector<unsigned int>& indices,
+    const MeshBounds& bounds)
+    : vertices(vertices), indices(indices), VAO(0), VBO(0), EBO(0), bounds(bounds)
 {
     //    ,     OpenGL
     setupMesh();
@@ -18,7 +20,8 @@ Mesh::Mesh(const std::vector<Vertex>& vertices,
 Mesh::Mesh(Mesh&& other) noexcept
     : vertices(std::move(other.vertices)),
     indices(std::move(other.indices)),
-    VAO(other.VAO), VBO(other.VBO), EBO(other.EBO)
+    VAO(other.VAO), VBO(other.VBO), EBO(other.EBO),
+    bounds(other.bounds)
 {
     //   
     other.VAO = 0;
@@ -38,6 +41,7 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
         VAO = other.VAO;
         VBO = other.VBO;
         EBO = other.EBO;
+        bounds = other.bounds;
 
         //   
         other.VAO = 0;
@@ -53,6 +57,10 @@ Mesh::~Mesh() {
 
 void Mesh::cleanUp() {
     if (VAO != 0) {
+        GLStateCache& state = GLStateCache::get();
+        state.forgetVertexArray(VAO);
+        state.forgetBuffer(VBO);
+        state.forgetBuffer(EBO);
         glDeleteVertexArrays(1, &VAO);
         glDeleteBuffers(1, &VBO);
         glDeleteBuffers(1, &EBO);
@@ -71,14 +79,15 @@ void Mesh::setupMesh() {
     glGenBuffers(1, &EBO);
 
     // 2.  VAO (Vertex Array Object)
-    glBindVertexArray(VAO);
+    GLStateCache& state = GLStateCache::get();
+    state.bindVertexArray(VAO);
 
     // 3.  VBO (Vertex Buffer Object)
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    state.bindBuffer(GL_ARRAY_BUFFER, VBO);
     //   
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
 
-    // 4.  EBO (Element Buffer Object)
+    // 4.  EBO (Element Buffer Object) -   VAO,    
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     //   
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
@@ -101,7 +110,7 @@ void Mesh::setupMesh() {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
 
     // 5.  VAO
-    glBindVertexArray(0);
+    state.bindVertexArray(0);
 }
 
 void Mesh::draw() const {
@@ -110,8 +119,9 @@ void Mesh::draw() const {
         return;
     }
 
-    //  VAO,     
-    glBindVertexArray(VAO);
+    //  VAO,     .
+    // VAO    :        
+    GLStateCache::get().bindVertexArray(VAO);
 
     //       (EBO)
     // GL_TRIANGLES -  
@@ -119,7 +129,13 @@ void Mesh::draw() const {
     // GL_UNSIGNED_INT -  
     // 0 - 
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+}
+
+void Mesh::drawInstanced(int instanceCount) const {
+    if (VAO == 0 || indices.empty() || instanceCount <= 0) {
+        return;
+    }
 
-    //  VAO
-    glBindVertexArray(0);
+    GLStateCache::get().bindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0, instanceCount);
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <algorithm>
+#include <cmath>
 
 // ----------------------------------------------------------------------
 //  
@@ -90,6 +92,27 @@ static MeshParser::FaceIndex parseFaceIndex(const std::string& faceStr) {
     return result;
 }
 
+//  : AABB   ,      AABB.
+//  -     (  ),     AABB.
+MeshBounds MeshParser::computeBounds(const std::vector<Vertex>& vertices) {
+    MeshBounds bounds;
+    bounds.min = bounds.max = vertices.front().position;
+    for (const Vertex& vertex : vertices) {
+        const Vec3& p = vertex.position;
+        bounds.min = Vec3(std::min(bounds.min.x, p.x), std::min(bounds.min.y, p.y), std::min(bounds.min.z, p.z));
+        bounds.max = Vec3(std::max(bounds.max.x, p.x), std::max(bounds.max.y, p.y), std::max(bounds.max.z, p.z));
+    }
+
+    bounds.center = (bounds.min + bounds.max) * 0.5f;
+    float radiusSq = 0.0f;
+    for (const Vertex& vertex : vertices) {
+        Vec3 d = vertex.position - bounds.center;
+        radiusSq = std::max(radiusSq, d.x * d.x + d.y * d.y + d.z * d.z);
+    }
+    bounds.radius = std::sqrt(radiusSq);
+    return bounds;
+}
+
 // ----------------------------------------------------------------------
 //   
 // ----------------------------------------------------------------------
@@ -202,7 +225,7 @@ Mesh MeshParser::parseObj(const std::string& filePath) {
     }
 
     //   Mesh,    setupMesh()  
-    return Mesh(vertices, indices);
+    return Mesh(vertices, indices, computeBounds(vertices));
 }
 
 // ----------------------------------------------------------------------
@@ -333,5 +356,5 @@ Mesh MeshParser::parseCubeAsPlatform(const std::string& filePath,
         throw std::runtime_error("ERROR::MESHPARSER: No valid vertices or faces found in file: " + filePath);
     }
 
-    return Mesh(vertices, indices);
+    return Mesh(vertices, indices, computeBounds(vertices));
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "../include/Object.h"
-#include "../include/Shader.h"
 #include "../include/MathUtils.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring> //  memcpy
 
@@ -37,12 +37,64 @@ void Object::updateModelMatrix() {
 
     // 3. : T * (R * S) -> T * tempMatrix
     MathUtils::multiplyMatrix4x4(T, tempMatrix, modelMatrix);
+
+    // 4.   -    ( ,     )
+    if (spatialIndex) {
+        AABB bounds;
+        getWorldBounds(bounds);
+        spatialIndex->move(spatialProxy, bounds);
+    }
 }
 
 // ----------------------------------------------------------------------
 //  
 // ----------------------------------------------------------------------
 
+void Object::getWorldBoundingSphere(Vec3& center, float& radius) const {
+    const MeshBounds& bounds = mesh->getBounds();
+    const float* m = modelMatrix;
+    const Vec3& c = bounds.center;
+    center = Vec3(m[0] * c.x + m[4] * c.y + m[8] * c.z + m[12],
+                  m[1] * c.x + m[5] * c.y + m[9] * c.z + m[13],
+                  m[2] * c.x + m[6] * c.y + m[10] * c.z + m[14]);
+
+    //   3x3 -     (   )
+    float scaleSq = std::max({ m[0] * m[0] + m[1] * m[1] + m[2] * m[2],
+                               m[4] * m[4] + m[5] * m[5] + m[6] * m[6],
+                               m[8] * m[8] + m[9] * m[9] + m[10] * m[10] });
+    radius = bounds.radius * std::sqrt(scaleSq);
+}
+
+void Object::getWorldBounds(AABB& bounds) const {
+    const float* m = modelMatrix;
+    if (!mesh) {
+        bounds.min = bounds.max = Vec3(m[12], m[13], m[14]);
+        return;
+    }
+
+    //  :   3x3       min/max 
+    const MeshBounds& local = mesh->getBounds();
+    const float localMin[3] = { local.min.x, local.min.y, local.min.z };
+    const float localMax[3] = { local.max.x, local.max.y, local.max.z };
+    float worldMin[3] = { m[12], m[13], m[14] };
+    float worldMax[3] = { m[12], m[13], m[14] };
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            float a = m[col * 4 + row] * localMin[col];
+            float b = m[col * 4 + row] * localMax[col];
+            worldMin[row] += std::min(a, b);
+            worldMax[row] += std::max(a, b);
+        }
+    }
+    bounds.min = Vec3(worldMin[0], worldMin[1], worldMin[2]);
+    bounds.max = Vec3(worldMax[0], worldMax[1], worldMax[2]);
+}
+
+void Object::setSpatialProxy(SpatialIndex* index, int proxy) {
+    spatialIndex = index;
+    spatialProxy = proxy;
+}
+
 void Object::getModelMatrix(float modelMatrixArray[16]) const {
     std::memcpy(modelMatrixArray, modelMatrix, 16 * sizeof(float));
 }
@@ -61,33 +113,3 @@ void Object::setScale(const Vec3& newScale) {
     scale = newScale;
     updateModelMatrix();
 }
-
-// ----------------------------------------------------------------------
-//  
-// ----------------------------------------------------------------------
-
-void Object::draw(const Shader& shader) const {
-    if (!mesh || !material) {
-        return;
-    }
-
-    // 1.   (,   0)
-    material->getTexture().bind(0);
-
-    // 2.  Uniforms,    /
-
-    //   ()
-    shader.setMat4("model", modelMatrix);
-
-    //   ( Phong, Custom)
-    shader.setVec3("material.ambient", material->ambient);
-    shader.setVec3("material.diffuse", material->diffuse);
-    shader.setVec3("material.specular", material->specular);
-    shader.setFloat("material.shininess", material->shininess);
-
-    //     
-    shader.setInt("material.texture_diffuse1", 0);
-
-    // 3.  
-    mesh->draw();
-}
\ No newline at end of file
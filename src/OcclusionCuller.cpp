@@ -0,0 +1,177 @@
+#include "../include/OcclusionCuller.h"
+#include "../include/Shader.h"
+#include "../include/MeshParser.h"
+#include <algorithm>
+#include <iostream>
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+OcclusionCuller::OcclusionCuller() {
+    //   [0, 1]^3:      AABB 
+    std::vector<Vertex> vertices;
+    for (int i = 0; i < 8; ++i) {
+        Vertex vertex;
+        vertex.position = Vec3(static_cast<float>(i & 1), static_cast<float>((i >> 1) & 1), static_cast<float>((i >> 2) & 1));
+        vertex.normal = Vec3(0.0f, 0.0f, 0.0f);
+        vertex.texCoords = Vec2(0.0f, 0.0f);
+        vertices.push_back(vertex);
+    }
+    std::vector<unsigned int> indices = {
+        0, 2, 1,  1, 2, 3,    // z = 0
+        4, 5, 6,  5, 7, 6,    // z = 1
+        0, 1, 4,  1, 5, 4,    // y = 0
+        2, 6, 3,  3, 6, 7,    // y = 1
+        0, 4, 2,  2, 4, 6,    // x = 0
+        1, 3, 5,  3, 7, 5     // x = 1
+    };
+    proxyMesh = std::make_unique<Mesh>(vertices, indices, MeshParser::computeBounds(vertices));
+}
+
+OcclusionCuller::~OcclusionCuller() {
+    releaseQueries();
+}
+
+void OcclusionCuller::releaseQueries() {
+    for (Record& record : records) {
+        glDeleteQueries(2, record.queries);
+    }
+    records.clear();
+}
+
+void OcclusionCuller::resize(size_t objectCount) {
+    size_t oldCount = records.size();
+    if (objectCount < oldCount) {
+        for (size_t i = objectCount; i < oldCount; ++i) {
+            glDeleteQueries(2, records[i].queries);
+        }
+    }
+
+    records.resize(objectCount);
+    objectStats.resize(objectCount);
+    for (size_t i = oldCount; i < objectCount; ++i) {
+        glGenQueries(2, records[i].queries);
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void OcclusionCuller::beginFrame() {
+    stats = Stats();
+
+    //    -     
+    int previousSlot = 1 - frameSlot;
+    for (size_t i = 0; i < records.size(); ++i) {
+        Record& record = records[i];
+
+        //     :     
+        record.issued[frameSlot] = false;
+        if (!record.issued[previousSlot]) {
+            continue;
+        }
+
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(record.queries[previousSlot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            //  :     ,    
+            stats.resultsPending++;
+            continue;
+        }
+
+        GLuint samplesPassed = GL_FALSE;
+        glGetQueryObjectuiv(record.queries[previousSlot], GL_QUERY_RESULT, &samplesPassed);
+        record.visible = samplesPassed != GL_FALSE;
+        record.issued[previousSlot] = false;
+
+        stats.resultsRead++;
+        objectStats[i].tested++;
+        if (!record.visible) {
+            objectStats[i].occluded++;
+        }
+    }
+
+    for (const Record& record : records) {
+        stats.occluded += record.visible ? 0 : 1;
+    }
+}
+
+void OcclusionCuller::endFrame() {
+    frameSlot = 1 - frameSlot;
+}
+
+// ----------------------------------------------------------------------
+// -
+// ----------------------------------------------------------------------
+
+void OcclusionCuller::beginProxyPass(const Shader& shader) {
+    proxyShader = &shader;
+    shader.use();
+
+    //    ; LEQUAL -        
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDepthFunc(GL_LEQUAL);
+}
+
+void OcclusionCuller::endProxyPass() {
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    proxyShader = nullptr;
+}
+
+void OcclusionCuller::issueQuery(size_t object, const AABB& bounds) {
+    //  :      ,     
+    Vec3 extent = bounds.max - bounds.min;
+    Vec3 margin = extent * 0.01f + Vec3(0.01f, 0.01f, 0.01f);
+    Vec3 origin = bounds.min - margin;
+    Vec3 size = extent + margin * 2.0f;
+
+    //        AABB ( )
+    float model[16] = {
+        size.x, 0.0f, 0.0f, 0.0f,
+        0.0f, size.y, 0.0f, 0.0f,
+        0.0f, 0.0f, size.z, 0.0f,
+        origin.x, origin.y, origin.z, 1.0f
+    };
+    proxyShader->set(proxyShader->standardUniforms().model, model);
+
+    Record& record = records[object];
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, record.queries[frameSlot]);
+    proxyMesh->draw();
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+    record.issued[frameSlot] = true;
+    stats.queriesIssued++;
+}
+
+void OcclusionCuller::markVisible(size_t object) {
+    records[object].visible = true;
+    records[object].issued[frameSlot] = false;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void OcclusionCuller::printObjectStats(size_t maxObjects) const {
+    std::vector<size_t> order(objectStats.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return objectStats[a].occluded > objectStats[b].occluded;
+    });
+
+    std::cout << "INFO::OCCLUSION: Most occluded objects:" << std::endl;
+    for (size_t k = 0; k < order.size() && k < maxObjects; ++k) {
+        const ObjectStats& object = objectStats[order[k]];
+        if (object.occluded == 0) {
+            break;
+        }
+        std::cout << "  - object " << order[k] << ": occluded in " << object.occluded << " of "
+                  << object.tested << " queries." << std::endl;
+    }
+}
@@ -0,0 +1,376 @@
+#include "../include/OcclusionRasterizer.h"
+#include "../include/Mesh.h"
+#include "../include/MathUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OCCLUSION_RASTERIZER_SSE
+#endif
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+OcclusionRasterizer::OcclusionRasterizer()
+    : depth(WIDTH * HEIGHT, 1.0f), blockMaxDepth(BLOCKS_X * BLOCKS_Y, 1.0f)
+{
+    MathUtils::createIdentityMatrix(viewProjection);
+
+    //     ,     ,  
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    unsigned workerCount = hardwareThreads > 1 ? std::min(hardwareThreads - 1, MAX_WORKERS) : 0;
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&OcclusionRasterizer::workerLoop, this);
+    }
+}
+
+OcclusionRasterizer::~OcclusionRasterizer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+const char* OcclusionRasterizer::instructionSet() {
+#if defined(OCCLUSION_RASTERIZER_SSE)
+    return "SSE, 4 pixels per step";
+#else
+    return "scalar";
+#endif
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void OcclusionRasterizer::beginFrame(const float matrix[16]) {
+    std::copy(matrix, matrix + 16, viewProjection);
+    triangles.clear();
+    for (auto& bin : tileBins) {
+        bin.clear();
+    }
+    stats = Stats();
+}
+
+void OcclusionRasterizer::addOccluder(const Mesh& mesh, const float modelMatrix[16]) {
+    float mvp[16];
+    MathUtils::multiplyMatrix4x4(viewProjection, modelMatrix, mvp);
+
+    clipVertices.resize(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const Vec3& p = mesh.vertices[i].position;
+        ClipVertex& v = clipVertices[i];
+        v.x = mvp[0] * p.x + mvp[4] * p.y + mvp[8] * p.z + mvp[12];
+        v.y = mvp[1] * p.x + mvp[5] * p.y + mvp[9] * p.z + mvp[13];
+        v.z = mvp[2] * p.x + mvp[6] * p.y + mvp[10] * p.z + mvp[14];
+        v.w = mvp[3] * p.x + mvp[7] * p.y + mvp[11] * p.z + mvp[15];
+    }
+
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        clipAndAddTriangle(clipVertices[mesh.indices[i]],
+                           clipVertices[mesh.indices[i + 1]],
+                           clipVertices[mesh.indices[i + 2]]);
+    }
+}
+
+void OcclusionRasterizer::clipAndAddTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2) {
+    //     OpenGL (z = -w);   
+    //     
+    const ClipVertex* input[3] = { &v0, &v1, &v2 };
+    float distance[3];
+    int insideCount = 0;
+    for (int i = 0; i < 3; ++i) {
+        distance[i] = input[i]->z + input[i]->w;
+        insideCount += distance[i] >= 0.0f ? 1 : 0;
+    }
+
+    if (insideCount == 3) {
+        setupTriangle(v0, v1, v2);
+        return;
+    }
+    if (insideCount == 0) {
+        return;
+    }
+
+    // Sutherland-Hodgman   :    3  4 
+    ClipVertex polygon[4];
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        if (distance[i] >= 0.0f) {
+            polygon[count++] = *input[i];
+        }
+        if ((distance[i] >= 0.0f) != (distance[j] >= 0.0f)) {
+            float t = distance[i] / (distance[i] - distance[j]);
+            const ClipVertex& a = *input[i];
+            const ClipVertex& b = *input[j];
+            polygon[count++] = ClipVertex{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                                           a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t };
+        }
+    }
+
+    for (int i = 1; i + 1 < count; ++i) {
+        setupTriangle(polygon[0], polygon[i], polygon[i + 1]);
+    }
+}
+
+void OcclusionRasterizer::setupTriangle(const ClipVertex& c0, const ClipVertex& c1, const ClipVertex& c2) {
+    //  :  (x, y)  [x, x + 1) x [y, y + 1),  - (x + 0.5, y + 0.5)
+    float x[3], y[3], z[3];
+    const ClipVertex* clip[3] = { &c0, &c1, &c2 };
+    for (int i = 0; i < 3; ++i) {
+        float invW = 1.0f / clip[i]->w;
+        x[i] = (clip[i]->x * invW * 0.5f + 0.5f) * WIDTH;
+        y[i] = (clip[i]->y * invW * 0.5f + 0.5f) * HEIGHT;
+        z[i] = clip[i]->z * invW;
+    }
+
+    //    ;     
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::fabs(area) < 1e-6f) {
+        return;
+    }
+
+    Triangle triangle;
+    triangle.minX = std::max(0, static_cast<int>(std::ceil(std::min({ x[0], x[1], x[2] }) - 0.5f)));
+    triangle.maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(std::max({ x[0], x[1], x[2] }) - 0.5f)));
+    triangle.minY = std::max(0, static_cast<int>(std::ceil(std::min({ y[0], y[1], y[2] }) - 0.5f)));
+    triangle.maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(std::max({ y[0], y[1], y[2] }) - 0.5f)));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+        return;
+    }
+
+    // и  ,       
+    float orientation = area > 0.0f ? 1.0f : -1.0f;
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        triangle.edgeA[i] = (y[i] - y[j]) * orientation;
+        triangle.edgeB[i] = (x[j] - x[i]) * orientation;
+        triangle.edgeC[i] = -(triangle.edgeA[i] * x[i] + triangle.edgeB[i] * y[i]);
+    }
+
+    //  : z/w    
+    triangle.zA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+    triangle.zB = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+    triangle.zC = z[0] - triangle.zA * x[0] - triangle.zB * y[0];
+
+    uint32_t index = static_cast<uint32_t>(triangles.size());
+    triangles.push_back(triangle);
+    for (int ty = triangle.minY / TILE_HEIGHT; ty <= triangle.maxY / TILE_HEIGHT; ++ty) {
+        for (int tx = triangle.minX / TILE_WIDTH; tx <= triangle.maxX / TILE_WIDTH; ++tx) {
+            tileBins[ty * TILES_X + tx].push_back(index);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void OcclusionRasterizer::rasterize() {
+    auto start = std::chrono::steady_clock::now();
+    stats.occluderTriangles = triangles.size();
+
+    if (triangles.empty()) {
+        std::fill(depth.begin(), depth.end(), 1.0f);
+        std::fill(blockMaxDepth.begin(), blockMaxDepth.end(), 1.0f);
+    }
+    else {
+        nextTile.store(0);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers = static_cast<unsigned>(workers.size());
+            ++generation;
+        }
+        wake.notify_all();
+
+        processTiles();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return busyWorkers == 0; });
+    }
+
+    stats.rasterizeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void OcclusionRasterizer::workerLoop() {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        processTiles();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void OcclusionRasterizer::processTiles() {
+    for (int tile = nextTile.fetch_add(1); tile < TILE_COUNT; tile = nextTile.fetch_add(1)) {
+        rasterizeTile(tile);
+    }
+}
+
+void OcclusionRasterizer::rasterizeTile(int tile) {
+    const int tileX0 = (tile % TILES_X) * TILE_WIDTH;
+    const int tileY0 = (tile / TILES_X) * TILE_HEIGHT;
+    const int tileX1 = tileX0 + TILE_WIDTH - 1;
+    const int tileY1 = tileY0 + TILE_HEIGHT - 1;
+
+    for (int y = tileY0; y <= tileY1; ++y) {
+        std::fill_n(&depth[y * WIDTH + tileX0], TILE_WIDTH, 1.0f);
+    }
+
+    for (uint32_t index : tileBins[tile]) {
+        const Triangle& t = triangles[index];
+        //     4 :    4,    
+        const int x0 = std::max(t.minX, tileX0) & ~3;
+        const int x1 = std::min(t.maxX, tileX1);
+        const int y0 = std::max(t.minY, tileY0);
+        const int y1 = std::min(t.maxY, tileY1);
+
+#if defined(OCCLUSION_RASTERIZER_SSE)
+        const __m128 a0 = _mm_set1_ps(t.edgeA[0]), a1 = _mm_set1_ps(t.edgeA[1]), a2 = _mm_set1_ps(t.edgeA[2]);
+        const __m128 step0 = _mm_set1_ps(t.edgeA[0] * 4.0f);
+        const __m128 step1 = _mm_set1_ps(t.edgeA[1] * 4.0f);
+        const __m128 step2 = _mm_set1_ps(t.edgeA[2] * 4.0f);
+        const __m128 stepZ = _mm_set1_ps(t.zA * 4.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x0) + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+
+        for (int y = y0; y <= y1; ++y) {
+            const float py = static_cast<float>(y) + 0.5f;
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), _mm_set1_ps(t.edgeB[0] * py + t.edgeC[0]));
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), _mm_set1_ps(t.edgeB[1] * py + t.edgeC[1]));
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), _mm_set1_ps(t.edgeB[2] * py + t.edgeC[2]));
+            __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.zA), px), _mm_set1_ps(t.zB * py + t.zC));
+
+            float* row = &depth[y * WIDTH];
+            for (int x = x0; x <= x1; x += 4) {
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                           _mm_cmpge_ps(e2, zero));
+                if (_mm_movemask_ps(inside) != 0) {
+                    __m128 old = _mm_loadu_ps(row + x);
+                    __m128 nearest = _mm_min_ps(old, z);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+                }
+                e0 = _mm_add_ps(e0, step0);
+                e1 = _mm_add_ps(e1, step1);
+                e2 = _mm_add_ps(e2, step2);
+                z = _mm_add_ps(z, stepZ);
+            }
+        }
+#else
+        for (int y = y0; y <= y1; ++y) {
+            const float py = static_cast<float>(y) + 0.5f;
+            float* row = &depth[y * WIDTH];
+            for (int x = x0; x <= x1; ++x) {
+                const float px = static_cast<float>(x) + 0.5f;
+                bool inside = true;
+                for (int i = 0; i < 3; ++i) {
+                    inside = inside && t.edgeA[i] * px + t.edgeB[i] * py + t.edgeC[i] >= 0.0f;
+                }
+                if (inside) {
+                    row[x] = std::min(row[x], t.zA * px + t.zB * py + t.zC);
+                }
+            }
+        }
+#endif
+    }
+
+    //  Z:     
+    for (int by = tileY0 / BLOCK_SIZE; by <= tileY1 / BLOCK_SIZE; ++by) {
+        for (int bx = tileX0 / BLOCK_SIZE; bx <= tileX1 / BLOCK_SIZE; ++bx) {
+            float farthest = 0.0f;
+            for (int y = by * BLOCK_SIZE; y < (by + 1) * BLOCK_SIZE; ++y) {
+                const float* row = &depth[y * WIDTH + bx * BLOCK_SIZE];
+                farthest = std::max(farthest, *std::max_element(row, row + BLOCK_SIZE));
+            }
+            blockMaxDepth[by * BLOCKS_X + bx] = farthest;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+bool OcclusionRasterizer::isOccluded(const AABB& bounds) {
+    stats.tested++;
+
+    const float* m = viewProjection;
+    float minX = static_cast<float>(WIDTH), maxX = 0.0f;
+    float minY = static_cast<float>(HEIGHT), maxY = 0.0f;
+    float nearestZ = 1.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        Vec3 p((corner & 1) ? bounds.max.x : bounds.min.x,
+               (corner & 2) ? bounds.max.y : bounds.min.y,
+               (corner & 4) ? bounds.max.z : bounds.min.z);
+        float cx = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
+        float cy = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
+        float cz = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14];
+        float cw = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
+
+        //    :   ,   
+        if (cz < -cw) {
+            return false;
+        }
+
+        float invW = 1.0f / cw;
+        float sx = (cx * invW * 0.5f + 0.5f) * WIDTH;
+        float sy = (cy * invW * 0.5f + 0.5f) * HEIGHT;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        nearestZ = std::min(nearestZ, cz * invW);
+    }
+
+    //  ,     (    )
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+    int x1 = std::min(WIDTH - 1, static_cast<int>(std::floor(maxX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+    int y1 = std::min(HEIGHT - 1, static_cast<int>(std::floor(maxY)));
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    for (int by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; ++by) {
+        for (int bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; ++bx) {
+            //    AABB -    
+            if (blockMaxDepth[by * BLOCKS_X + bx] < nearestZ) {
+                continue;
+            }
+
+            int px0 = std::max(x0, bx * BLOCK_SIZE), px1 = std::min(x1, bx * BLOCK_SIZE + BLOCK_SIZE - 1);
+            int py0 = std::max(y0, by * BLOCK_SIZE), py1 = std::min(y1, by * BLOCK_SIZE + BLOCK_SIZE - 1);
+            for (int y = py0; y <= py1; ++y) {
+                const float* row = &depth[y * WIDTH];
+                for (int x = px0; x <= px1; ++x) {
+                    if (row[x] >= nearestZ) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    stats.occluded++;
+    return true;
+}
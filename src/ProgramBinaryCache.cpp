@@ -0,0 +1,160 @@
+#include "../include/ProgramBinaryCache.h"
+#include "../include/AssetRegistry.h" //  AssetRegistry::hashBytes
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+//    
+static const char CACHE_MAGIC[4] = { 'P', 'B', 'I', 'N' };
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+    : cacheDirectory(directory), supported(false)
+{
+    auto glString = [](GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+    };
+    driverId = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+
+    //    ,      (  )
+    if (GLEW_ARB_get_program_binary) {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        supported = formatCount > 0;
+    }
+
+    if (!supported) {
+        std::cout << "INFO::PROGRAM_CACHE: Program binaries are not supported by the driver, cache disabled." << std::endl;
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDirectory, ec);
+    if (ec) {
+        std::cerr << "WARNING::PROGRAM_CACHE: Could not create cache directory: " << cacheDirectory << std::endl;
+        supported = false;
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+std::string ProgramBinaryCache::makeKey(const std::vector<std::string>& sources, const std::string& defines) const {
+    uint64_t hash = AssetRegistry::hashBytes(driverId.data(), driverId.size());
+    hash = AssetRegistry::hashBytes(defines.data(), defines.size(), hash);
+    for (const auto& source : sources) {
+        //    ,       
+        uint64_t length = source.size();
+        hash = AssetRegistry::hashBytes(&length, sizeof(length), hash);
+        hash = AssetRegistry::hashBytes(source.data(), source.size(), hash);
+    }
+
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+std::string ProgramBinaryCache::entryPath(const std::string& key) const {
+    return cacheDirectory + "/" + key + ".bin";
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+bool ProgramBinaryCache::load(const std::string& key, GLuint program) {
+    if (!supported) {
+        return false;
+    }
+
+    std::ifstream file(entryPath(key), std::ios::binary);
+    if (!file.is_open()) {
+        stats.misses++;
+        return false;
+    }
+
+    //  : "PBIN" | GLenum format | uint32 length | 
+    char magic[4] = {};
+    uint32_t format = 0;
+    uint32_t length = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    file.read(reinterpret_cast<char*>(&length), sizeof(length));
+
+    std::vector<char> binary(length);
+    if (length > 0) {
+        file.read(binary.data(), length);
+    }
+
+    if (!file || std::char_traits<char>::compare(magic, CACHE_MAGIC, 4) != 0 || length == 0) {
+        std::cerr << "WARNING::PROGRAM_CACHE: Corrupted cache entry " << key << ", rebuilding." << std::endl;
+        stats.rejected++;
+        return false;
+    }
+
+    glProgramBinary(program, (GLenum)format, binary.data(), (GLsizei)length);
+
+    //     ( ,  ) -   
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        stats.rejected++;
+        return false;
+    }
+
+    stats.hits++;
+    return true;
+}
+
+void ProgramBinaryCache::store(const std::string& key, GLuint program) {
+    if (!supported) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    //      ,     
+    std::string path = entryPath(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "WARNING::PROGRAM_CACHE: Could not write cache entry: " << tempPath << std::endl;
+            return;
+        }
+
+        uint32_t format32 = format;
+        uint32_t length32 = (uint32_t)written;
+        file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&format32), sizeof(format32));
+        file.write(reinterpret_cast<const char*>(&length32), sizeof(length32));
+        file.write(binary.data(), written);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+    stats.stored++;
+}
@@ -0,0 +1,155 @@
+#include "../include/QualityGovernor.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+QualityGovernor::QualityGovernor(double targetMs) : targetMs(targetMs) {}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void QualityGovernor::update(Scene& scene) {
+    //       ,  
+    double frameMs = scene.getRenderStats().gpuFrameMs;
+    if (!enabled || frameMs <= 0.0) {
+        return;
+    }
+
+    averageMs = averageMs > 0.0 ? averageMs + SMOOTHING * (frameMs - averageMs) : frameMs;
+    if (++framesSinceChange < SETTLE_FRAMES) {
+        return;
+    }
+
+    float scale = scene.getRenderScale();
+
+    //       -  
+    if (!steps.empty() && steps.back().savedMs < 0.0) {
+        steps.back().savedMs = std::max(0.0, steps.back().frameMsBefore - averageMs);
+    }
+
+    if (averageMs > targetMs * OVER_BUDGET) {
+        underBudgetAtMaximum = 0;
+        if (scale > MIN_SCALE) {
+            //  ~   ~ scale^2
+            float next = scale * static_cast<float>(std::sqrt(targetMs / averageMs));
+            setScale(scene, std::max({ next, scale - MAX_SCALE_STEP_DOWN, MIN_SCALE }));
+        }
+        else if (++overBudgetAtMinimum >= SECONDARY_PATIENCE) {
+            overBudgetAtMinimum = 0;
+            if (stepDownSecondary(scene)) {
+                restartMeasurement();
+            }
+        }
+        return;
+    }
+
+    overBudgetAtMinimum = 0;
+    if (averageMs >= targetMs * UNDER_BUDGET) {
+        underBudgetAtMaximum = 0;
+        return;
+    }
+
+    //  :     (  )
+    if (!steps.empty()) {
+        if (averageMs + steps.back().savedMs >= targetMs * UNDER_BUDGET) {
+            underBudgetAtMaximum = 0;
+            return;
+        }
+        if (++underBudgetAtMaximum >= SECONDARY_PATIENCE) {
+            underBudgetAtMaximum = 0;
+            stepUpSecondary(scene);
+            restartMeasurement();
+        }
+        return;
+    }
+
+    if (scale < 1.0f) {
+        //  -   ,       
+        double aimMs = targetMs * (OVER_BUDGET + UNDER_BUDGET) * 0.5;
+        float next = scale * static_cast<float>(std::sqrt(aimMs / averageMs));
+        setScale(scene, std::min({ next, scale + MAX_SCALE_STEP_UP, 1.0f }));
+    }
+}
+
+void QualityGovernor::setScale(Scene& scene, float scale) {
+    if (std::abs(scale - scene.getRenderScale()) < 0.01f) {
+        return;
+    }
+    std::cout << "INFO::QUALITY_GOVERNOR: Render scale " << scene.getRenderScale() << " -> " << scale
+              << " (GPU " << averageMs << " ms, target " << targetMs << " ms)." << std::endl;
+    scene.setRenderScale(scale);
+    restartMeasurement();
+}
+
+bool QualityGovernor::stepDownSecondary(Scene& scene) {
+    SecondaryStep step{ SecondaryStep::Knob::ANTIALIASING, scene.getAntialiasing(), scene.getMaxLightsPerCluster(),
+                        averageMs, -1.0 };
+
+    // 1. :   MSAA,  FXAA,   
+    AntialiasingMode mode = scene.getAntialiasing();
+    if (mode != AntialiasingMode::NONE) {
+        AntialiasingMode lower = static_cast<AntialiasingMode>(static_cast<int>(mode) - 1);
+        std::cout << "INFO::QUALITY_GOVERNOR: Antialiasing " << antialiasingModeName(mode) << " -> "
+                  << antialiasingModeName(lower) << " (GPU " << averageMs << " ms)." << std::endl;
+        scene.setAntialiasing(lower);
+        steps.push_back(step);
+        return true;
+    }
+
+    // 2.  :     (    )
+    size_t longest = scene.getRenderStats().maxLightsPerCluster;
+    size_t limit = std::max(MIN_CLUSTER_LIGHTS, longest / 2);
+    if (scene.getRenderStats().clusterLightReferences > 0 && limit < longest) {
+        std::cout << "INFO::QUALITY_GOVERNOR: Max lights per cluster " << longest << " -> " << limit
+                  << " (GPU " << averageMs << " ms)." << std::endl;
+        step.knob = SecondaryStep::Knob::CLUSTER_LIGHTS;
+        scene.setMaxLightsPerCluster(limit);
+        steps.push_back(step);
+        return true;
+    }
+    return false;
+}
+
+void QualityGovernor::stepUpSecondary(Scene& scene) {
+    SecondaryStep step = steps.back();
+    steps.pop_back();
+
+    if (step.knob == SecondaryStep::Knob::ANTIALIASING) {
+        std::cout << "INFO::QUALITY_GOVERNOR: Antialiasing restored to " << antialiasingModeName(step.antialiasing)
+                  << " (GPU " << averageMs << " ms)." << std::endl;
+        scene.setAntialiasing(step.antialiasing);
+    }
+    else {
+        std::cout << "INFO::QUALITY_GOVERNOR: Max lights per cluster restored (GPU " << averageMs << " ms)." << std::endl;
+        scene.setMaxLightsPerCluster(step.clusterLights);
+    }
+}
+
+void QualityGovernor::restartMeasurement() {
+    averageMs = 0.0;
+    framesSinceChange = 0;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void QualityGovernor::reset(Scene& scene) {
+    while (!steps.empty()) {
+        stepUpSecondary(scene);
+    }
+    scene.setRenderScale(1.0f);
+    overBudgetAtMinimum = 0;
+    underBudgetAtMaximum = 0;
+    restartMeasurement();
+}
+
+void QualityGovernor::setEnabled(bool enabled, Scene& scene) {
+    this->enabled = enabled;
+    if (!enabled) {
+        reset(scene);
+    }
+    std::cout << "INFO::QUALITY_GOVERNOR: " << (enabled ? "Enabled" : "Disabled")
+              << " (target " << targetMs << " ms)." << std::endl;
+}
@@ -0,0 +1,515 @@
+#include "../include/RenderGraph.h"
+#include "../include/GLStateCache.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+RenderGraph::RenderGraph() {
+    //     ,   core-   VAO
+    glGenVertexArrays(1, &emptyVertexArray);
+
+    glGenSamplers(1, &linearSampler);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+RenderGraph::~RenderGraph() {
+    GLStateCache& state = GLStateCache::get();
+    for (const auto& entry : framebuffers) {
+        glDeleteFramebuffers(1, &entry.second);
+    }
+    for (const PooledTexture& texture : pool) {
+        state.forgetTexture(texture.id);
+        glDeleteTextures(1, &texture.id);
+    }
+    state.forgetVertexArray(emptyVertexArray);
+    glDeleteVertexArrays(1, &emptyVertexArray);
+    glDeleteSamplers(1, &linearSampler);
+
+    for (auto& frame : timerFrames) {
+        for (const auto& timer : frame) {
+            glDeleteQueries(1, &timer.second);
+        }
+    }
+    if (!freeTimerQueries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(freeTimerQueries.size()), freeTimerQueries.data());
+    }
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void RenderGraph::reset() {
+    resources.clear();
+    passes.clear();
+}
+
+RenderGraph::Resource RenderGraph::importTarget() {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, targetViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, targetClearColor);
+
+    ResourceNode node;
+    node.name = "target";
+    node.imported = true;
+    resources.push_back(node);
+    return static_cast<Resource>(resources.size() - 1);
+}
+
+RenderGraph::TextureDesc RenderGraph::targetSizedDesc(GLenum internalFormat, int samples, float scale) const {
+    TextureDesc desc;
+    if (scale < 1.0f) {
+        desc.width = std::max(1, static_cast<int>(targetViewport[2] * scale + 0.5f));
+        desc.height = std::max(1, static_cast<int>(targetViewport[3] * scale + 0.5f));
+    }
+    else {
+        //       : gl_FragCoord    
+        desc.width = targetViewport[0] + targetViewport[2];
+        desc.height = targetViewport[1] + targetViewport[3];
+    }
+    desc.internalFormat = internalFormat;
+    desc.samples = samples;
+    return desc;
+}
+
+void RenderGraph::addPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute) {
+    PassNode node;
+    node.name = name;
+    node.execute = std::move(execute);
+    passes.push_back(std::move(node));
+
+    PassBuilder builder(*this, passes.size() - 1);
+    setup(builder);
+}
+
+RenderGraph::Resource RenderGraph::PassBuilder::create(const std::string& name, const TextureDesc& desc) {
+    if (desc.width <= 0 || desc.height <= 0) {
+        throw std::runtime_error("ERROR::RENDER_GRAPH: Resource '" + name + "' has an empty size.");
+    }
+
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    graph.resources.push_back(node);
+    return static_cast<Resource>(graph.resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::PassBuilder::read(Resource resource) {
+    if (resource < 0 || static_cast<size_t>(resource) >= graph.resources.size()) {
+        throw std::runtime_error("ERROR::RENDER_GRAPH: Pass '" + graph.passes[pass].name + "' reads an unknown resource.");
+    }
+    graph.passes[pass].reads.push_back(resource);
+    return resource;
+}
+
+RenderGraph::Resource RenderGraph::PassBuilder::write(Resource resource, bool clear) {
+    if (resource < 0 || static_cast<size_t>(resource) >= graph.resources.size()) {
+        throw std::runtime_error("ERROR::RENDER_GRAPH: Pass '" + graph.passes[pass].name + "' writes an unknown resource.");
+    }
+
+    PassNode& node = graph.passes[pass];
+    ResourceNode& target = graph.resources[resource];
+
+    //      ,   :     
+    if (target.imported) {
+        if (clear) {
+            throw std::runtime_error("ERROR::RENDER_GRAPH: Imported target is cleared by its owner, not by pass '" + node.name + "'.");
+        }
+        if (!node.colorWrites.empty() || node.depthWrite >= 0) {
+            throw std::runtime_error("ERROR::RENDER_GRAPH: Pass '" + node.name + "' mixes the imported target with transient targets.");
+        }
+        node.writesTarget = true;
+        return resource;
+    }
+    if (node.writesTarget) {
+        throw std::runtime_error("ERROR::RENDER_GRAPH: Pass '" + node.name + "' mixes the imported target with transient targets.");
+    }
+
+    if (isDepthFormat(target.desc.internalFormat)) {
+        node.depthWrite = resource;
+    }
+    else {
+        node.colorWrites.push_back(resource);
+    }
+    if (clear) {
+        node.clears.push_back(resource);
+        node.clearColors.push_back({ 0.0f, 0.0f, 0.0f, 0.0f });
+    }
+    return resource;
+}
+
+RenderGraph::Resource RenderGraph::PassBuilder::write(Resource resource, const GLfloat clearColor[4]) {
+    write(resource, true);
+
+    PassNode& node = graph.passes[pass];
+    if (node.depthWrite == resource) {
+        throw std::runtime_error("ERROR::RENDER_GRAPH: Pass '" + node.name + "' clears a depth resource with a color.");
+    }
+    std::copy(clearColor, clearColor + 4, node.clearColors.back().begin());
+    return resource;
+}
+
+void RenderGraph::PassBuilder::setSideEffect() {
+    graph.passes[pass].sideEffect = true;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void RenderGraph::compile() {
+    stats = Stats();
+    stats.passes = passes.size();
+
+    // 1. :      (  ).
+    //  ,   ,      ,    
+    std::vector<uint8_t> needed(resources.size(), 0);
+    for (size_t p = passes.size(); p-- > 0;) {
+        PassNode& pass = passes[p];
+        pass.live = pass.sideEffect || pass.writesTarget;
+        for (Resource resource : pass.colorWrites) {
+            pass.live = pass.live || needed[resource];
+        }
+        if (pass.depthWrite >= 0) {
+            pass.live = pass.live || needed[pass.depthWrite];
+        }
+
+        if (!pass.live) {
+            stats.passesCulled++;
+            continue;
+        }
+        for (Resource resource : pass.reads) {
+            needed[resource] = 1;
+        }
+    }
+
+    // 2.    :      ,   
+    for (size_t p = 0; p < passes.size(); ++p) {
+        const PassNode& pass = passes[p];
+        if (!pass.live) {
+            continue;
+        }
+        auto touch = [this, p](Resource resource) {
+            ResourceNode& node = resources[resource];
+            if (node.imported) {
+                return;
+            }
+            if (node.firstPass < 0) {
+                node.firstPass = static_cast<int>(p);
+            }
+            node.lastPass = static_cast<int>(p);
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), touch);
+        std::for_each(pass.colorWrites.begin(), pass.colorWrites.end(), touch);
+        if (pass.depthWrite >= 0) {
+            touch(pass.depthWrite);
+        }
+    }
+
+    // 3. :      ,     
+    for (PooledTexture& texture : pool) {
+        texture.used = false;
+        texture.busyUntil = -1;
+    }
+    for (size_t p = 0; p < passes.size(); ++p) {
+        for (ResourceNode& node : resources) {
+            if (node.firstPass == static_cast<int>(p)) {
+                node.texture = acquireTexture(node.desc, node.firstPass, node.lastPass);
+                stats.transientResources++;
+                stats.transientBytes += static_cast<size_t>(node.desc.width) * node.desc.height * node.desc.samples
+                                        * bytesPerTexel(node.desc.internalFormat);
+            }
+        }
+    }
+
+    // 4. ,    ( ,  ),  
+    GLStateCache& state = GLStateCache::get();
+    for (size_t i = pool.size(); i-- > 0;) {
+        if (pool[i].used) {
+            continue;
+        }
+        forgetFramebuffers(pool[i].id);
+        state.forgetTexture(pool[i].id);
+        glDeleteTextures(1, &pool[i].id);
+        pool.erase(pool.begin() + i);
+
+        //    
+        for (ResourceNode& node : resources) {
+            if (node.texture > static_cast<int>(i)) {
+                node.texture--;
+            }
+        }
+    }
+
+    stats.textures = pool.size();
+    for (const PooledTexture& texture : pool) {
+        stats.allocatedBytes += static_cast<size_t>(texture.desc.width) * texture.desc.height * texture.desc.samples
+                                * bytesPerTexel(texture.desc.internalFormat);
+    }
+}
+
+int RenderGraph::acquireTexture(const TextureDesc& desc, int firstPass, int lastPass) {
+    for (size_t i = 0; i < pool.size(); ++i) {
+        PooledTexture& texture = pool[i];
+        if (texture.desc == desc && texture.busyUntil < firstPass) {
+            texture.used = true;
+            texture.busyUntil = lastPass;
+            return static_cast<int>(i);
+        }
+    }
+
+    PooledTexture texture;
+    texture.desc = desc;
+    texture.used = true;
+    texture.busyUntil = lastPass;
+    glGenTextures(1, &texture.id);
+
+    GLStateCache& state = GLStateCache::get();
+    if (desc.samples > 1) {
+        //  :  ,     
+        state.bindTexture(0, texture.id, GL_TEXTURE_2D_MULTISAMPLE);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, desc.samples, desc.internalFormat, desc.width, desc.height, GL_TRUE);
+        state.bindTexture(0, 0, GL_TEXTURE_2D_MULTISAMPLE);
+        std::cout << "INFO::RENDER_GRAPH: Allocated " << desc.width << "x" << desc.height << " x" << desc.samples
+                  << " multisample target (format 0x" << std::hex << desc.internalFormat << std::dec << ")." << std::endl;
+
+        pool.push_back(texture);
+        return static_cast<int>(pool.size() - 1);
+    }
+
+    //   texelFetch:    mipmap
+    state.bindTexture(0, texture.id);
+    GLenum format = GL_RGBA;
+    GLenum type = GL_FLOAT;
+    if (desc.internalFormat == GL_DEPTH24_STENCIL8 || desc.internalFormat == GL_DEPTH32F_STENCIL8) {
+        format = GL_DEPTH_STENCIL;
+        type = desc.internalFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 : GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+    }
+    else if (isDepthFormat(desc.internalFormat)) {
+        format = GL_DEPTH_COMPONENT;
+    }
+    glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    state.bindTexture(0, 0);
+
+    std::cout << "INFO::RENDER_GRAPH: Allocated " << desc.width << "x" << desc.height
+              << " target (format 0x" << std::hex << desc.internalFormat << std::dec << ")." << std::endl;
+
+    pool.push_back(texture);
+    return static_cast<int>(pool.size() - 1);
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void RenderGraph::execute() {
+    PassContext context(*this);
+    const GLfloat farDepth = 1.0f;
+
+    //     TIMER_FRAMES  :     
+    std::vector<std::pair<std::string, GLuint>>& timers = timerFrames[timerFrame];
+    timerFrame = (timerFrame + 1) % TIMER_FRAMES;
+    collectPassTimes(timers);
+
+    for (const PassNode& pass : passes) {
+        if (!pass.live) {
+            continue;
+        }
+
+        GLuint timer = 0;
+        if (freeTimerQueries.empty()) {
+            glGenQueries(1, &timer);
+        }
+        else {
+            timer = freeTimerQueries.back();
+            freeTimerQueries.pop_back();
+        }
+        timers.emplace_back(pass.name, timer);
+        glBeginQuery(GL_TIME_ELAPSED, timer);
+
+        bool transient = !pass.colorWrites.empty() || pass.depthWrite >= 0;
+        bool customViewport = false;
+        if (transient) {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebufferFor(pass));
+
+            //    (,  )    
+            Resource first = pass.colorWrites.empty() ? pass.depthWrite : pass.colorWrites.front();
+            const TextureDesc& desc = resources[first].desc;
+            if (!(desc == targetSizedDesc(desc.internalFormat, desc.samples))) {
+                glViewport(0, 0, desc.width, desc.height);
+                customViewport = true;
+            }
+
+            for (size_t i = 0; i < pass.clears.size(); ++i) {
+                Resource resource = pass.clears[i];
+                if (resource == pass.depthWrite) {
+                    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+                    continue;
+                }
+                auto it = std::find(pass.colorWrites.begin(), pass.colorWrites.end(), resource);
+                glClearBufferfv(GL_COLOR, static_cast<GLint>(it - pass.colorWrites.begin()), pass.clearColors[i].data());
+            }
+        }
+        else {
+            glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(targetFramebuffer));
+        }
+
+        pass.execute(context);
+
+        if (customViewport) {
+            glViewport(targetViewport[0], targetViewport[1], targetViewport[2], targetViewport[3]);
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(targetFramebuffer));
+}
+
+void RenderGraph::collectPassTimes(std::vector<std::pair<std::string, GLuint>>& frame) {
+    //      -    
+    GLuint ready = GL_FALSE;
+    if (!frame.empty()) {
+        glGetQueryObjectuiv(frame.back().second, GL_QUERY_RESULT_AVAILABLE, &ready);
+    }
+
+    if (ready) {
+        passTimes.clear();
+        for (const auto& timer : frame) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(timer.second, GL_QUERY_RESULT, &nanoseconds);
+            passTimes.push_back({ timer.first, static_cast<double>(nanoseconds) / 1.0e6 });
+        }
+    }
+
+    //   :    ,   GPU
+    for (const auto& timer : frame) {
+        freeTimerQueries.push_back(timer.second);
+    }
+    frame.clear();
+}
+
+GLuint RenderGraph::framebufferFor(const PassNode& pass) {
+    std::vector<GLuint> key;
+    for (Resource resource : pass.colorWrites) {
+        key.push_back(pool[resources[resource].texture].id);
+    }
+    key.push_back(pass.depthWrite >= 0 ? pool[resources[pass.depthWrite].texture].id : 0);
+
+    auto it = framebuffers.find(key);
+    if (it != framebuffers.end()) {
+        return it->second;
+    }
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    std::vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < pass.colorWrites.size(); ++i) {
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, textureTarget(resources[pass.colorWrites[i]].desc), key[i], 0);
+        drawBuffers.push_back(attachment);
+    }
+    if (pass.depthWrite >= 0) {
+        GLenum format = resources[pass.depthWrite].desc.internalFormat;
+        GLenum attachment = (format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8)
+            ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, textureTarget(resources[pass.depthWrite].desc), key.back(), 0);
+    }
+
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+    }
+    else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glDeleteFramebuffers(1, &framebuffer);
+        throw std::runtime_error("ERROR::RENDER_GRAPH: Framebuffer of pass '" + pass.name + "' is incomplete (status "
+                                 + std::to_string(status) + ").");
+    }
+
+    framebuffers.emplace(key, framebuffer);
+    return framebuffer;
+}
+
+void RenderGraph::forgetFramebuffers(GLuint texture) {
+    for (auto it = framebuffers.begin(); it != framebuffers.end();) {
+        if (std::find(it->first.begin(), it->first.end(), texture) != it->first.end()) {
+            glDeleteFramebuffers(1, &it->second);
+            it = framebuffers.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+GLuint RenderGraph::PassContext::texture(Resource resource) const {
+    const ResourceNode& node = graph.resources[resource];
+    if (node.imported || node.texture < 0) {
+        return 0;
+    }
+    return graph.pool[node.texture].id;
+}
+
+void RenderGraph::PassContext::bindTexture(Resource resource, unsigned int unit, bool linear) const {
+    const TextureDesc& desc = graph.resources[resource].desc;
+    GLStateCache::get().bindTexture(unit, texture(resource), textureTarget(desc));
+    glBindSampler(unit, linear && desc.samples == 1 ? graph.linearSampler : 0);
+}
+
+void RenderGraph::PassContext::drawFullscreen() const {
+    GLStateCache::get().bindVertexArray(graph.emptyVertexArray);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+GLenum RenderGraph::textureTarget(const TextureDesc& desc) {
+    return desc.samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+}
+
+bool RenderGraph::isDepthFormat(GLenum internalFormat) {
+    switch (internalFormat) {
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+    case GL_DEPTH32F_STENCIL8:
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t RenderGraph::bytesPerTexel(GLenum internalFormat) {
+    switch (internalFormat) {
+    case GL_R8: return 1;
+    case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+    case GL_RGBA16F: case GL_DEPTH32F_STENCIL8: return 8;
+    case GL_RGBA32F: return 16;
+    default: return 4;   // RGBA8, RG16F, R32F, R11F_G11F_B10F, DEPTH24, DEPTH24_STENCIL8, ...
+    }
+}
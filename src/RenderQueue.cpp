@@ -0,0 +1,80 @@
+#include "../include/RenderQueue.h"
+#include <algorithm>
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+uint64_t RenderQueue::makeKey(RenderPass pass, uint32_t program, uint32_t material, uint32_t mesh, uint32_t depth) {
+    auto field = [](uint32_t value, int bits) { return static_cast<uint64_t>(value) & ((1ull << bits) - 1); };
+
+    uint64_t key = field(static_cast<uint32_t>(pass), PASS_BITS);
+    key = (key << PROGRAM_BITS) | field(program, PROGRAM_BITS);
+    key = (key << MATERIAL_BITS) | field(material, MATERIAL_BITS);
+    key = (key << MESH_BITS) | field(mesh, MESH_BITS);
+    key = (key << DEPTH_BITS) | field(depth, DEPTH_BITS);
+    return key;
+}
+
+uint32_t RenderQueue::quantizeDepth(float viewDepth, float nearPlane, float farPlane) {
+    const uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+    float range = farPlane - nearPlane;
+    if (range <= 0.0f) {
+        return 0;
+    }
+
+    float normalized = std::clamp((viewDepth - nearPlane) / range, 0.0f, 1.0f);
+    return static_cast<uint32_t>(normalized * static_cast<float>(maxDepth));
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+void RenderQueue::clear() {
+    commands.clear();
+    entries.clear();
+    sorted.clear();
+    stats = Stats();
+}
+
+void RenderQueue::submit(uint64_t key, const DrawCommand& command) {
+    entries.push_back({ key, static_cast<uint32_t>(commands.size()) });
+    commands.push_back(command);
+}
+
+void RenderQueue::sort() {
+    stats.commands = entries.size();
+    scratch.resize(entries.size());
+
+    // LSD:     ,   ( + ).
+    // ,     (   ,  ),
+    //    -     .
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const SortEntry& entry : entries) {
+            counts[(entry.key >> shift) & 0xFF]++;
+        }
+        if (entries.empty() || counts[(entries[0].key >> shift) & 0xFF] == entries.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const SortEntry& entry : entries) {
+            scratch[counts[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        entries.swap(scratch);
+        stats.radixPasses++;
+    }
+
+    //    ,       
+    sorted.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        sorted[i] = commands[entries[i].command];
+    }
+}
@@ -1,13 +1,15 @@
 #include "../include/Scene.h"
-#include "../include/MeshParser.h" //   
+#include "../include/MathUtils.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
 // ----------------------------------------------------------------------
 // 
 // ----------------------------------------------------------------------
 
-Scene::Scene(ShaderManager& shaderMgr)
-    : shaderManager(shaderMgr), activeSpotLightIndex(-1), activePointLightIndex(-1)
+Scene::Scene(ShaderManager& shaderMgr, AssetRegistry& registry)
+    : shaderManager(shaderMgr), assetRegistry(registry), activeSpotLightIndex(-1), activePointLightIndex(-1)
 {
     // setupScene()   Application::initialize()
 }
@@ -53,18 +55,19 @@ void Scene::setupLights() {
 
 void Scene::setupObjects() {
     //      
-    auto whiteTexture = std::make_shared<Texture>("src/res/textures/white_diffuse.png", false);
+    //     :          OpenGL
+    auto whiteTexture = assetRegistry.loadTexture("src/res/textures/white_diffuse.png", false);
 
     // ---   ---
     // ,      OBJ-  res/models/
-    std::shared_ptr<Mesh> cubeMesh = std::make_shared<Mesh>(MeshParser::parseObj("src/res/models/cube.obj"));
-    std::shared_ptr<Mesh> sphereMesh = std::make_shared<Mesh>(MeshParser::parseObj("src/res/models/sphere.obj"));
-    std::shared_ptr<Mesh> planeMesh = std::make_shared<Mesh>(MeshParser::parseCubeAsPlatform("src/res/models/plane.obj"));
+    std::shared_ptr<Mesh> cubeMesh = assetRegistry.loadMesh("src/res/models/cube.obj");
+    std::shared_ptr<Mesh> sphereMesh = assetRegistry.loadMesh("src/res/models/sphere.obj");
+    std::shared_ptr<Mesh> planeMesh = assetRegistry.loadPlatformMesh("src/res/models/plane.obj");
 
     // ---   ---
 
     // 1.  PHONG ()
-    auto matPhong = std::make_shared<Material>(
+    auto matPhong = assetRegistry.getMaterial(
         sf::Vector3f(0.3f, 0.3f, 0.3f),   // Ambient
         sf::Vector3f(0.8f, 0.6f, 0.3f),   // Diffuse
         sf::Vector3f(1.0f, 1.0f, 1.0f),   // Specular
@@ -72,7 +75,7 @@ void Scene::setupObjects() {
     );
 
     // 2.  TOON SHADING
-    auto matToon = std::make_shared<Material>(
+    auto matToon = assetRegistry.getMaterial(
         sf::Vector3f(0.2f, 0.2f, 0.2f),   // Ambient ()
         sf::Vector3f(0.3f, 0.8f, 0.3f),   // Diffuse
         sf::Vector3f(0.0f, 0.0f, 0.0f),   // Specular
@@ -80,7 +83,7 @@ void Scene::setupObjects() {
     );
 
     // 3.  CUSTOM MODEL ()
-    auto matCustom = std::make_shared<Material>(
+    auto matCustom = assetRegistry.getMaterial(
         sf::Vector3f(0.2f, 0.2f, 0.2f),   // Ambient ()
         sf::Vector3f(0.9f, 0.1f, 0.1f),   // Diffuse
         sf::Vector3f(0.0f, 0.0f, 0.0f),   // Specular
@@ -92,6 +95,7 @@ void Scene::setupObjects() {
     // 1.  (Plane, Phong)
     auto floor = std::make_shared<Object>(planeMesh, matPhong);
     floor->setScale(sf::Vector3f(10.0f, 1.0f, 10.0f));
+    floor->setOccluder(true);
     objects.push_back(floor);
 
     // 2.  1 (Phong)
@@ -102,11 +106,13 @@ void Scene::setupObjects() {
     // 3.  1 (Toon)
     auto cube1 = std::make_shared<Object>(cubeMesh, matToon);
     cube1->setPosition(sf::Vector3f(0.0f, 1.0f, 0.0f));
+    cube1->setOccluder(true);
     objects.push_back(cube1);
 
     // 4.  2 (Custom)
     auto cube2 = std::make_shared<Object>(cubeMesh, matCustom);
     cube2->setPosition(sf::Vector3f(2.0f, 1.0f, 0.0f));
+    cube2->setOccluder(true);
     objects.push_back(cube2);
 
     // 5.  2 (Toon)
@@ -116,7 +122,32 @@ void Scene::setupObjects() {
     objects.push_back(sphere2);
 }
 
-void Scene::sendLightDataToShader(Shader& shader) {
+//      (,  ,  , ).
+//   ,   :     ,      - 
+static bool sphereIntersectsCone(const Vec3& center, float radius, const Vec3& apex, const Vec3& axis,
+                                 float cosAngle, float sinAngle, float range) {
+    Vec3 v = center - apex;
+    float along = v.x * axis.x + v.y * axis.y + v.z * axis.z;
+    float across = std::sqrt(std::max(v.x * v.x + v.y * v.y + v.z * v.z - along * along, 0.0f));
+    float closest = cosAngle * across - along * sinAngle;
+    return !(closest > radius || along > radius + range || along < -radius);
+}
+
+//  Vec3   float[3]  std140
+static void storeVec3(float* destination, const Vec3& value) {
+    destination[0] = value.x;
+    destination[1] = value.y;
+    destination[2] = value.z;
+}
+
+void Scene::updateFrameUniforms(const Camera& camera, const float* viewMatrix, const float* projMatrix) {
+    //    (  ),       
+    FrameUniforms::CameraBlock cameraBlock{};
+    std::memcpy(cameraBlock.view, viewMatrix, sizeof(cameraBlock.view));
+    std::memcpy(cameraBlock.projection, projMatrix, sizeof(cameraBlock.projection));
+    storeVec3(cameraBlock.viewPos, camera.Position);
+
+    FrameUniforms::LightBlock lightBlock{};
     int pointLightCount = 0;
     int spotLightCount = 0;
 
@@ -125,39 +156,64 @@ void Scene::sendLightDataToShader(Shader& shader) {
 
         //  
         if (auto dirLight = std::dynamic_pointer_cast<DirectionalLight>(light)) {
-            shader.setVec3("dirLight.direction", dirLight->direction);
-            shader.setVec3("dirLight.color", dirLight->color);
-            shader.setFloat("dirLight.ambientIntensity", dirLight->ambientIntensity);
+            storeVec3(lightBlock.dirLight.direction, dirLight->direction);
+            storeVec3(lightBlock.dirLight.color, dirLight->color);
+            lightBlock.dirLight.ambientIntensity = dirLight->ambientIntensity;
 
             //  
         }
         else if (auto pLight = std::dynamic_pointer_cast<PointLight>(light)) {
-            std::string base = "pointLights[" + std::to_string(pointLightCount++) + "].";
-            shader.setVec3(base + "position", pLight->position);
-            shader.setVec3(base + "color", pLight->color);
-            shader.setFloat(base + "constant", pLight->constant);
-            shader.setFloat(base + "linear", pLight->linear);
-            shader.setFloat(base + "quadratic", pLight->quadratic);
+            if (pointLightCount >= MAX_POINT_LIGHTS) {
+                continue; //    
+            }
+            FrameUniforms::PointLightBlock& p = lightBlock.pointLights[pointLightCount++];
+            storeVec3(p.position, pLight->position);
+            storeVec3(p.color, pLight->color);
+            p.constant = pLight->constant;
+            p.linear = pLight->linear;
+            p.quadratic = pLight->quadratic;
 
             // 
         }
         else if (auto sLight = std::dynamic_pointer_cast<SpotLight>(light)) {
-            std::string base = "spotLights[" + std::to_string(spotLightCount++) + "].";
-            shader.setVec3(base + "position", sLight->position);
-            shader.setVec3(base + "direction", sLight->direction);
-            shader.setVec3(base + "color", sLight->color);
-            shader.setFloat(base + "cutOff", sLight->cutOff);
-            shader.setFloat(base + "outerCutOff", sLight->outerCutOff);
-            //   !
-            shader.setFloat(base + "constant", sLight->constant);
-            shader.setFloat(base + "linear", sLight->linear);
-            shader.setFloat(base + "quadratic", sLight->quadratic);
+            if (spotLightCount >= MAX_SPOT_LIGHTS) {
+                continue;
+            }
+            FrameUniforms::SpotLightBlock& sl = lightBlock.spotLights[spotLightCount++];
+            storeVec3(sl.position, sLight->position);
+            storeVec3(sl.direction, sLight->direction);
+            storeVec3(sl.color, sLight->color);
+            sl.cutOff = sLight->cutOff;
+            sl.outerCutOff = sLight->outerCutOff;
+            sl.constant = sLight->constant;
+            sl.linear = sLight->linear;
+            sl.quadratic = sLight->quadratic;
         }
     }
 
-    //      (    )
-    shader.setInt("numPointLights", pointLightCount);
-    shader.setInt("numSpotLights", spotLightCount);
+    //     (    )
+    lightBlock.numPointLights = pointLightCount;
+    lightBlock.numSpotLights = spotLightCount;
+
+    frameUniforms->update(cameraBlock, lightBlock);
+}
+
+void Scene::setProgramConstants(const Shader& shader) {
+    //   -  0,   -    (  render())
+    const StandardUniforms& u = shader.standardUniforms();
+    shader.set(u.material.textureDiffuse, 0);
+    shader.set(u.lookupTables.orenNayar, static_cast<int>(LightingLUT::OREN_NAYAR_UNIT));
+    shader.set(u.lookupTables.toonRamp, static_cast<int>(LightingLUT::TOON_RAMP_UNIT));
+    shader.set(u.clusters.lights, static_cast<int>(LightClusters::LIGHTS_UNIT));
+    shader.set(u.clusters.ranges, static_cast<int>(LightClusters::RANGES_UNIT));
+    shader.set(u.clusters.indices, static_cast<int>(LightClusters::INDICES_UNIT));
+    shader.set(u.gBuffer.position, static_cast<int>(GBUFFER_POSITION_UNIT));
+    shader.set(u.gBuffer.normal, static_cast<int>(GBUFFER_NORMAL_UNIT));
+    shader.set(u.gBuffer.albedo, static_cast<int>(GBUFFER_ALBEDO_UNIT));
+    shader.set(u.gBuffer.depth, static_cast<int>(GBUFFER_DEPTH_UNIT));
+    shader.set(u.postProcess.sceneColor, static_cast<int>(SCENE_COLOR_UNIT));
+    shader.set(u.impostor.albedo, static_cast<int>(ImpostorAtlas::ALBEDO_UNIT));
+    shader.set(u.impostor.normalDepth, static_cast<int>(ImpostorAtlas::NORMAL_DEPTH_UNIT));
 }
 
 // ----------------------------------------------------------------------
@@ -257,9 +313,53 @@ void Scene::setupScene() {
     try {
         setupLights();
         setupObjects();
+
+        //    toon  Oren-Nayar;  toon  ,     
+        lightingLUT = std::make_unique<LightingLUT>(TOON_RAMP_PATH);
+
+        //    -  uniform-     
+        frameUniforms = std::make_unique<FrameUniforms>();
+
+        //    -    GPU,    
+        materialTable = std::make_unique<MaterialTable>();
+        registerMaterials();
+
+        //    -  BVH     
+        indexObjects();
+
+        //      (   ..)
+        streamBuffer = std::make_unique<StreamBuffer>(GL_UNIFORM_BUFFER, STREAM_FRAME_SIZE);
+
+        //   (  , . setOcclusionCulling)
+        occlusionCuller = std::make_unique<OcclusionCuller>();
+
+        //     CPU (    )
+        occlusionRasterizer = std::make_unique<OcclusionRasterizer>();
+
+        //     (,     )
+        lightClusters = std::make_unique<LightClusters>();
+
+        //   (   -   ,   )
+        renderGraph = std::make_unique<RenderGraph>();
+
+        std::cout << "INFO::SCENE: Frustum culling: " << FrustumCuller::instructionSet() << "." << std::endl;
+        std::cout << "INFO::SCENE: Software occlusion: " << OcclusionRasterizer::WIDTH << "x" << OcclusionRasterizer::HEIGHT
+                  << " depth buffer, " << OcclusionRasterizer::instructionSet() << ", "
+                  << occlusionRasterizer->getThreadCount() << " threads." << std::endl;
+        std::cout << "INFO::SCENE: Light clusters: " << LightClusters::GRID_X << "x" << LightClusters::GRID_Y << "x"
+                  << LightClusters::GRID_Z << ", " << LightClusters::instructionSet() << "." << std::endl;
+
         std::cout << "INFO::SCENE: Scene initialized with " << objects.size() << " objects and " << lights.size() << " lights." << std::endl;
         std::cout << "INFO::SCENE: SpotLight index: " << activeSpotLightIndex << std::endl;
         std::cout << "INFO::SCENE: PointLight index: " << activePointLightIndex << std::endl;
+
+        //    ,       
+        ShaderVariantKey lightingKey = makeLightingKey();
+        std::vector<ShaderVariantKey> keys;
+        for (const auto& object : objects) {
+            keys.push_back(makeVariantKey(object->getMaterial(), lightingKey));
+        }
+        shaderManager.precompileVariants(keys);
     }
     catch (const std::exception& e) {
         std::cerr << "FATAL ERROR::SCENE: Setup failed: " << e.what() << std::endl;
@@ -285,31 +385,1074 @@ void Scene::update(float deltaTime) {
 // ----------------------------------------------------------------------
 
 void Scene::render(const Camera& camera) {
+    const GLStateCache::Stats& stateStats = GLStateCache::get().getStats();
+    size_t issuedBefore = stateStats.totalIssued();
+    size_t skippedBefore = stateStats.totalSkipped();
+
     float viewMatrix[16];
     float projMatrix[16];
     camera.getViewMatrix(viewMatrix);
     camera.getProjectionMatrix(projMatrix);
 
-    //       
-    for (const auto& object : objects) {
-        // 1. ,    
-        LightingModel requiredModel = object->getMaterial().getLightingModel();
-        Shader& currentShader = shaderManager.getShader(requiredModel);
-        currentShader.use();
+    //       
+    lightingLUT->bind();
+
+    //         (   )
+    updateFrameUniforms(camera, viewMatrix, projMatrix);
+
+    //      (,  ,  )   
+    renderGraph->reset();
+    RenderGraph::Resource target = renderGraph->importTarget();
+
+    //    ,    LightData, -   
+    // ( -    ,   renderScale < 1)
+    clusteredFrame = makeLightingKey().clustered;
+    if (clusteredFrame) {
+        const GLint* viewport = renderGraph->getTargetViewport();
+        RenderGraph::TextureDesc sceneDesc = sceneTargetDesc(GL_RGBA8);
+        bool scaled = renderScale < 1.0f;
+        lightClusters->build(camera, viewMatrix, lights, scaled ? sceneDesc.width : viewport[2],
+                             scaled ? sceneDesc.height : viewport[3]);
+        lightClusters->bind();
+    }
+
+    //   -  ;      
+    if (objectMaterialIndices.size() != objects.size()) {
+        registerMaterials();
+    }
+    materialTable->sync();
+
+    //      ;    
+    if (spatialIndex.size() != objects.size()) {
+        indexObjects();
+    }
+
+    //    .   GPU_DRIVEN    ,
+    //  CPU     (    )
+    bool gpuCulling = renderMode == RenderMode::GPU_DRIVEN;
+    size_t culledCount = 0;
+    if (gpuCulling) {
+        objectVisible.assign(objects.size(), 1);
+    }
+    else {
+        culledCount = cullObjects(camera);
+    }
+
+    //          
+    size_t rasterOccludedCount = 0;
+    if (softwareOcclusion && !gpuCulling) {
+        float viewProjection[16];
+        MathUtils::multiplyMatrix4x4(projMatrix, viewMatrix, viewProjection);
+        rasterOccludedCount = rasterizeOccluders(viewProjection);
+    }
+
+    //  :     (  GPU)
+    occlusionTested.clear();
+    occlusionConfirmed.clear();
+    objectOcclusionTested.assign(objects.size(), 0);
+    bool occlusionFrame = occlusionCulling && !gpuCulling;
+    if (occlusionFrame) {
+        occlusionCuller->resize(objects.size());
+        occlusionCuller->beginFrame();
+        classifyOcclusion(camera);
+    }
+
+    renderStats = RenderStats();
+    renderStats.objectsCulled = culledCount;
+    renderStats.objectsRasterOccluded = rasterOccludedCount;
+    if (clusteredFrame) {
+        renderStats.clusterLightReferences = lightClusters->getStats().references;
+        renderStats.maxLightsPerCluster = lightClusters->getStats().maxPerCluster;
+    }
+    renderStats.objectsOccluded = occlusionTested.size();
+    renderStats.objectLightsCulled = cullObjectLights();
+
+    //   -  (    )
+    renderStats.impostors = selectImpostors(camera, projMatrix);
+
+    //      ( GPU,       );
+    //    ,      
+    reserveInstanceBlocks();
+    streamBuffer->beginFrame();
+
+    //  :      ,      
+    frameAntialiasing = antialiasing;
+    if (renderMode == RenderMode::DEFERRED && antialiasingSamples(antialiasing) > 1) {
+        frameAntialiasing = AntialiasingMode::NONE;
+    }
+
+    RenderGraph::Resource sceneColor = target;
+    if (renderMode == RenderMode::DEFERRED) {
+        sceneColor = addDeferredPasses(target);
+    }
+    else {
+        if (renderMode == RenderMode::PER_MODEL) {
+            recordDrawCommands(camera, viewMatrix);
+        }
+        if (renderMode == RenderMode::GPU_DRIVEN) {
+            Frustum frustum;
+            camera.getFrustum(frustum);
+            addIndirectCullingPass(frustum);
+        }
+        renderGraph->addPass("Forward",
+            [this, target, &sceneColor](RenderGraph::PassBuilder& builder) {
+                sceneColor = writeSceneTarget(builder, target);
+            },
+            [this](const RenderGraph::PassContext&) {
+                if (renderMode == RenderMode::UBERSHADER) {
+                    renderUber();
+                }
+                else if (renderMode == RenderMode::GPU_DRIVEN) {
+                    renderIndirect();
+                }
+                else {
+                    renderPerModel();
+                }
+            });
+    }
+    //         
+    RenderGraph::Resource finalColor = sceneColor;
+    if (frameAntialiasing != AntialiasingMode::NONE) {
+        finalColor = addAntialiasingPass(sceneColor, target);
+    }
+    if (renderScale < 1.0f) {
+        addUpscalePass(finalColor, target);
+    }
+    renderGraph->compile();
+    renderGraph->execute();
+
+    const RenderGraph::Stats& graphStats = renderGraph->getStats();
+    renderStats.renderPasses = graphStats.passes - graphStats.passesCulled;
+    renderStats.renderTargetBytes = graphStats.allocatedBytes;
+    renderStats.renderTargetBytesUnaliased = graphStats.transientBytes;
+    for (const RenderGraph::PassTime& pass : renderGraph->getPassTimes()) {
+        renderStats.gpuFrameMs += pass.milliseconds;
+        if (pass.name == ANTIALIASING_PASS) {
+            renderStats.gpuAntialiasingMs += pass.milliseconds;
+        }
+    }
+
+    streamBuffer->endFrame();
+
+    if (occlusionFrame) {
+        renderStats.occlusionQueries = occlusionCuller->getStats().queriesIssued;
+        occlusionCuller->endFrame();
+    }
+
+    renderStats.stateChangesIssued = stateStats.totalIssued() - issuedBefore;
+    renderStats.stateChangesSkipped = stateStats.totalSkipped() - skippedBefore;
+}
+
+void Scene::indexObjects() {
+    for (size_t i = 0; i < objects.size(); ++i) {
+        Object& object = *objects[i];
+        if (object.getSpatialProxy() >= 0) {
+            continue;
+        }
+        AABB bounds;
+        object.getWorldBounds(bounds);
+        object.setSpatialProxy(&spatialIndex, spatialIndex.insert(bounds, static_cast<uint32_t>(i)));
+    }
+}
+
+size_t Scene::cullObjects(const Camera& camera) {
+    Frustum frustum;
+    camera.getFrustum(frustum);
+
+    // 1.  :    ,   - 
+    spatialIndex.queryFrustum(frustum, insideObjects, boundaryObjects);
+
+    objectVisible.assign(objects.size(), 0);
+    size_t visibleCount = insideObjects.size();
+    for (uint32_t index : insideObjects) {
+        objectVisible[index] = 1;
+    }
+
+    // 2.     (  AABB  ) -   
+    culler.resize(boundaryObjects.size());
+    for (size_t k = 0; k < boundaryObjects.size(); ++k) {
+        const Object& object = *objects[boundaryObjects[k]];
+        Vec3 center(0.0f, 0.0f, 0.0f);
+        float radius = 0.0f;
+        if (object.isDrawable()) {
+            object.getWorldBoundingSphere(center, radius);
+        }
+        culler.setSphere(k, center.x, center.y, center.z, radius);
+    }
+    culler.cull(frustum, boundaryVisible);
+
+    for (size_t k = 0; k < boundaryObjects.size(); ++k) {
+        objectVisible[boundaryObjects[k]] = boundaryVisible[k];
+        visibleCount += boundaryVisible[k];
+    }
+    return objects.size() - visibleCount;
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void Scene::queryObjectsInSphere(const Vec3& center, float radius, std::vector<uint32_t>& result) const {
+    spatialIndex.querySphere(center, radius, result);
+}
+
+int Scene::pickObject(const Vec3& origin, const Vec3& direction, float maxDistance) const {
+    std::vector<SpatialIndex::RayHit> hits;
+    spatialIndex.queryRay(origin, direction, maxDistance, hits);
+    return hits.empty() ? -1 : static_cast<int>(hits.front().userData);
+}
+
+size_t Scene::rasterizeOccluders(const float* viewProjection) {
+    occlusionRasterizer->beginFrame(viewProjection);
+
+    // 1.         -   
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const Object& object = *objects[i];
+        if (objectVisible[i] && object.isOccluder() && object.isDrawable()) {
+            occlusionRasterizer->addOccluder(object.getMesh(), object.getModelMatrixData());
+        }
+    }
+    occlusionRasterizer->rasterize();
+
+    // 2.    ,   :
+    //   AABB    ,      
+    size_t occludedCount = 0;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!objectVisible[i]) {
+            continue;
+        }
+        AABB bounds;
+        objects[i]->getWorldBounds(bounds);
+        if (occlusionRasterizer->isOccluded(bounds)) {
+            objectVisible[i] = 0;
+            occludedCount++;
+        }
+    }
+    return occludedCount;
+}
+
+size_t Scene::cullObjectLights() {
+    objectCulledLights.assign(objects.size(), 0);
+
+    //      LightData:     
+    if (clusteredFrame) {
+        return 0;
+    }
+
+    size_t visibleCount = 0;
+    for (uint8_t visible : objectVisible) {
+        visibleCount += visible;
+    }
+
+    //       ,    updateFrameUniforms()
+    int pointLightCount = 0;
+    int spotLightCount = 0;
+    size_t culledPairs = 0;
+    for (const auto& light : lights) {
+        int bit = 0;
+        Vec3 position;
+        float range = 0.0f;
+        std::shared_ptr<SpotLight> spotLight;
+
+        if (auto pointLight = std::dynamic_pointer_cast<PointLight>(light)) {
+            if (pointLightCount >= MAX_POINT_LIGHTS) {
+                continue;
+            }
+            bit = 1 << pointLightCount++;
+            position = pointLight->position;
+            range = LightClusters::lightRange(pointLight->color, pointLight->constant, pointLight->linear, pointLight->quadratic);
+        }
+        else if ((spotLight = std::dynamic_pointer_cast<SpotLight>(light))) {
+            if (spotLightCount >= MAX_SPOT_LIGHTS) {
+                continue;
+            }
+            bit = 1 << (MAX_POINT_LIGHTS + spotLightCount++);
+            position = spotLight->position;
+            range = LightClusters::lightRange(spotLight->color, spotLight->constant, spotLight->linear, spotLight->quadratic);
+        }
+        else {
+            continue;
+        }
+
+        //       :  -  
+        lightObjects.clear();
+        if (!std::isfinite(range)) {
+            if (!spotLight) {
+                continue;
+            }
+            for (size_t i = 0; i < objects.size(); ++i) {
+                lightObjects.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        else if (range > 0.0f) {
+            spatialIndex.querySphere(position, range, lightObjects);
+        }
+
+        //     ,   ,   
+        for (size_t i = 0; i < objects.size(); ++i) {
+            if (objectVisible[i]) {
+                objectCulledLights[i] |= bit;
+            }
+        }
+
+        Vec3 axis;
+        float cosAngle = 0.0f;
+        float sinAngle = 0.0f;
+        if (spotLight) {
+            float length = std::sqrt(spotLight->direction.x * spotLight->direction.x + spotLight->direction.y * spotLight->direction.y
+                                     + spotLight->direction.z * spotLight->direction.z);
+            axis = length > 0.0f ? spotLight->direction / length : Vec3(0.0f, 0.0f, 0.0f);
+            cosAngle = std::clamp(spotLight->outerCutOff, -1.0f, 1.0f);
+            sinAngle = std::sqrt(1.0f - cosAngle * cosAngle);
+        }
+
+        size_t reached = 0;
+        for (uint32_t index : lightObjects) {
+            if (index >= objects.size() || !objectVisible[index]) {
+                continue;
+            }
+            if (spotLight) {
+                Vec3 center;
+                float radius = 0.0f;
+                objects[index]->getWorldBoundingSphere(center, radius);
+                if (!sphereIntersectsCone(center, radius, position, axis, cosAngle, sinAngle, range)) {
+                    continue;
+                }
+            }
+            objectCulledLights[index] &= ~bit;
+            reached++;
+        }
+        culledPairs += visibleCount - reached;
+    }
+    return culledPairs;
+}
+
+void Scene::classifyOcclusion(const Camera& camera) {
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!objectVisible[i]) {
+            continue;
+        }
+
+        //   AABB (    ):    
+        //     ,      
+        AABB bounds;
+        objects[i]->getWorldBounds(bounds);
+        Vec3 nearMargin(2.0f * camera.nearPlane, 2.0f * camera.nearPlane, 2.0f * camera.nearPlane);
+        AABB expanded{ bounds.min - nearMargin, bounds.max + nearMargin };
+        if (expanded.contains(AABB{ camera.Position, camera.Position })) {
+            occlusionCuller->markVisible(i);
+            continue;
+        }
+
+        if (occlusionCuller->wasVisible(i)) {
+            occlusionConfirmed.push_back(static_cast<uint32_t>(i));
+        }
+        else {
+            occlusionTested.push_back(static_cast<uint32_t>(i));
+            objectOcclusionTested[i] = 1;
+
+            //   G-   :    
+            // ,      
+            if (renderMode != RenderMode::PER_MODEL) {
+                objectVisible[i] = 0;
+            }
+        }
+    }
+}
+
+void Scene::issueOcclusionQueries(const std::vector<uint32_t>& objectIndices) {
+    if (objectIndices.empty()) {
+        return;
+    }
+
+    occlusionCuller->beginProxyPass(shaderManager.getOcclusionShader());
+    for (uint32_t index : objectIndices) {
+        AABB bounds;
+        objects[index]->getWorldBounds(bounds);
+        occlusionCuller->issueQuery(index, bounds);
+    }
+    occlusionCuller->endProxyPass();
+}
+
+void Scene::recordDrawCommands(const Camera& camera, const float* viewMatrix) {
+    //        
+    ShaderVariantKey lightingKey = makeLightingKey();
+    renderQueue.clear();
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const Object& object = *objects[i];
+        int materialIndex = objectMaterialIndices[i];
+        if (materialIndex < 0 || !objectVisible[i]) {
+            continue; //          
+        }
+
+        //     :   ,     
+        const Material& material = object.getMaterial();
+        const Shader& shader = shaderManager.getShader(makeVariantKey(material, lightingKey));
+
+        //     : -z    (   )
+        const float* model = object.getModelMatrixData();
+        float viewDepth = -(viewMatrix[2] * model[12] + viewMatrix[6] * model[13] + viewMatrix[10] * model[14] + viewMatrix[14]);
+
+        DrawCommand command;
+        command.shader = &shader;
+        command.mesh = &object.getMesh();
+        command.texture = material.hasTexture() ? &material.getTexture() : nullptr;
+        command.model = model;
+        command.materialIndex = materialIndex;
+        command.culledLights = objectCulledLights[i];
+        command.occlusionQuery = 0;
+
+        //         -     
+        RenderPass pass = RenderPass::OPAQUE_GEOMETRY;
+        if (objectOcclusionTested[i]) {
+            pass = RenderPass::OCCLUSION_TESTED;
+            command.occlusionQuery = occlusionCuller->currentQuery(i);
+        }
+
+        uint64_t key = RenderQueue::makeKey(pass, shader.getStateID(),
+                                            static_cast<uint32_t>(materialIndex), command.mesh->getVAO(),
+                                            RenderQueue::quantizeDepth(viewDepth, camera.nearPlane, camera.farPlane));
+        renderQueue.submit(key, command);
+    }
+
+    renderQueue.sort();
+}
+
+void Scene::renderPerModel() {
+    //   :      
+    const Shader* currentShader = nullptr;
+    bool testedQueriesIssued = false;
+
+    for (const DrawCommand& command : renderQueue.getCommands()) {
+        //   OCCLUSION_TESTED:      -  
+        if (command.occlusionQuery != 0 && !testedQueriesIssued) {
+            issueOcclusionQueries(occlusionTested);
+            testedQueriesIssued = true;
+            currentShader = nullptr;
+        }
+
+        if (command.shader != currentShader) {
+            currentShader = command.shader;
+            currentShader->use();
+            renderStats.programSwitches++;
+
+            //      uniform- ;     
+            setProgramConstants(*currentShader);
+        }
+
+        //         VAO   
+        if (command.texture) {
+            command.texture->bind(0);
+        }
+
+        const StandardUniforms& u = currentShader->standardUniforms();
+        currentShader->set(u.model, command.model);
+        currentShader->set(u.material.index, command.materialIndex);
+        currentShader->set(u.culledLights, command.culledLights);
+
+        // GPU   ,       (CPU   )
+        if (command.occlusionQuery != 0) {
+            glBeginConditionalRender(command.occlusionQuery, GL_QUERY_WAIT);
+            command.mesh->draw();
+            glEndConditionalRender();
+        }
+        else {
+            command.mesh->draw();
+        }
+        renderStats.drawCalls++;
+    }
+
+    //        -       
+    if (occlusionCulling) {
+        issueOcclusionQueries(occlusionConfirmed);
+    }
+}
+
+void Scene::renderUber() {
+    // 1.     
+    Shader& shader = shaderManager.getUberShader(clusteredFrame);
+    shader.use();
+    renderStats.programSwitches++;
+
+    setProgramConstants(shader);
 
-        // 2.   
-        currentShader.setMat4("view", viewMatrix);
-        currentShader.setMat4("projection", projMatrix);
+    // 2.  
+    drawInstanceBatches();
 
-        // 3.    ()
-        currentShader.setVec3("viewPos", camera.Position);
+    // 3.   -  ( :      )
+    drawImpostors(false);
 
-        // 4.    
-        sendLightDataToShader(currentShader);
+    //       ,     
+    if (occlusionCulling) {
+        issueOcclusionQueries(occlusionConfirmed);
+        issueOcclusionQueries(occlusionTested);
+    }
+}
+
+RenderGraph::Resource Scene::addDeferredPasses(RenderGraph::Resource target) {
+    //  G-    :     G- 
+    RenderGraph::Resource position = -1, normal = -1, albedo = -1, depth = -1;
+    RenderGraph::Resource sceneColor = -1;
+
+    // 1.  :   ,   ,      
+    renderGraph->addPass("GBuffer",
+        [&](RenderGraph::PassBuilder& builder) {
+            position = builder.write(builder.create("gPosition", sceneTargetDesc(GL_RGBA32F)), true);
+            normal = builder.write(builder.create("gNormal", sceneTargetDesc(GL_RGBA16F)), true);
+            albedo = builder.write(builder.create("gAlbedo", sceneTargetDesc(GL_RGBA8)), true);
+            depth = builder.write(builder.create("gDepth", sceneTargetDesc(GL_DEPTH_COMPONENT24)), true);
+        },
+        [this](const RenderGraph::PassContext&) {
+            Shader& geometryShader = shaderManager.getGeometryPassShader();
+            geometryShader.use();
+            renderStats.programSwitches++;
+            setProgramConstants(geometryShader);
+            drawInstanceBatches();
+            drawImpostors(true);
+
+            //     G- (     )
+            if (occlusionCulling) {
+                issueOcclusionQueries(occlusionConfirmed);
+                issueOcclusionQueries(occlusionTested);
+            }
+        });
+
+    // 2.  :    ,     
+    renderGraph->addPass("DeferredLighting",
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.read(position);
+            builder.read(normal);
+            builder.read(albedo);
+            builder.read(depth);
+            sceneColor = writeSceneTarget(builder, target);
+        },
+        [this, position, normal, albedo, depth](const RenderGraph::PassContext& context) {
+            context.bindTexture(position, GBUFFER_POSITION_UNIT);
+            context.bindTexture(normal, GBUFFER_NORMAL_UNIT);
+            context.bindTexture(albedo, GBUFFER_ALBEDO_UNIT);
+            context.bindTexture(depth, GBUFFER_DEPTH_UNIT);
+
+            Shader& lightingShader = shaderManager.getLightingPassShader(clusteredFrame);
+            lightingShader.use();
+            renderStats.programSwitches++;
+            setProgramConstants(lightingShader);
+            context.drawFullscreen();
+            renderStats.drawCalls++;
+        });
+    return sceneColor;
+}
+
+RenderGraph::TextureDesc Scene::sceneTargetDesc(GLenum internalFormat, int samples) const {
+    return renderGraph->targetSizedDesc(internalFormat, samples, renderScale);
+}
+
+RenderGraph::Resource Scene::writeSceneTarget(RenderGraph::PassBuilder& builder, RenderGraph::Resource target) {
+    if (frameAntialiasing == AntialiasingMode::NONE && renderScale >= 1.0f) {
+        return builder.write(target);
+    }
+
+    //     ;       
+    int samples = antialiasingSamples(frameAntialiasing);
+    builder.write(builder.create("sceneDepth", sceneTargetDesc(GL_DEPTH_COMPONENT24, samples)), true);
+    return builder.write(builder.create("sceneColor", sceneTargetDesc(GL_RGBA8, samples)),
+                         renderGraph->getTargetClearColor());
+}
+
+RenderGraph::Resource Scene::addAntialiasingPass(RenderGraph::Resource sceneColor, RenderGraph::Resource target) {
+    //          
+    RenderGraph::Resource output = target;
+    renderGraph->addPass(ANTIALIASING_PASS,
+        [this, sceneColor, target, &output](RenderGraph::PassBuilder& builder) {
+            builder.read(sceneColor);
+            if (renderScale < 1.0f) {
+                output = builder.write(builder.create("antialiasedColor", sceneTargetDesc(GL_RGBA8)));
+            }
+            else {
+                builder.write(target);
+            }
+        },
+        [this, sceneColor](const RenderGraph::PassContext& context) {
+            // FXAA     ;  MSAA  texelFetch
+            int samples = antialiasingSamples(frameAntialiasing);
+            context.bindTexture(sceneColor, SCENE_COLOR_UNIT, samples == 1);
+
+            Shader& shader = shaderManager.getAntialiasingShader(samples > 1);
+            shader.use();
+            renderStats.programSwitches++;
+            setProgramConstants(shader);
+            shader.set(shader.standardUniforms().postProcess.sampleCount, samples);
+            context.drawFullscreen();
+            renderStats.drawCalls++;
+        });
+    return output;
+}
+
+void Scene::addUpscalePass(RenderGraph::Resource sceneColor, RenderGraph::Resource target) {
+    renderGraph->addPass("Upscale",
+        [sceneColor, target](RenderGraph::PassBuilder& builder) {
+            builder.read(sceneColor);
+            builder.write(target);
+        },
+        [this, sceneColor](const RenderGraph::PassContext& context) {
+            context.bindTexture(sceneColor, SCENE_COLOR_UNIT, true);
+
+            //   ->    ->      ()
+            const GLint* viewport = renderGraph->getTargetViewport();
+            Shader& shader = shaderManager.getUpscaleShader();
+            shader.use();
+            renderStats.programSwitches++;
+            setProgramConstants(shader);
+            const PostProcessUniforms& u = shader.standardUniforms().postProcess;
+            shader.set(u.targetOrigin, Vec2(static_cast<float>(viewport[0]), static_cast<float>(viewport[1])));
+            shader.set(u.targetSize, Vec2(static_cast<float>(viewport[2]), static_cast<float>(viewport[3])));
+            context.drawFullscreen();
+            renderStats.drawCalls++;
+        });
+}
+
+bool Scene::isInstanceDrawn(size_t index, bool impostors) const {
+    //  ,   ,  ;  -      
+    return impostors ? objectImpostorFade[index] > 0.0f
+                     : objectVisible[index] && objectImpostorFade[index] < 1.0f;
+}
+
+size_t Scene::countInstanceBatches(bool impostors) const {
+    //   ,   drawInstanceBatches,   
+    size_t batches = 0;
+    size_t next = 0;
+    while (next < batchOrder.size()) {
+        if (!isInstanceDrawn(batchOrder[next], impostors)) {
+            ++next;
+            continue;
+        }
+
+        const Object& first = *objects[batchOrder[next]];
+        const Mesh* mesh = &first.getMesh();
+        const Texture* texture = first.getMaterial().texture.get();
+
+        int count = 0;
+        while (next < batchOrder.size() && count < MAX_UBER_INSTANCES) {
+            const Object& object = *objects[batchOrder[next]];
+            if (&object.getMesh() != mesh || object.getMaterial().texture.get() != texture) {
+                break;
+            }
+            if (isInstanceDrawn(batchOrder[next], impostors)) {
+                ++count;
+            }
+            ++next;
+        }
+        ++batches;
+    }
+    return batches;
+}
+
+void Scene::reserveInstanceBlocks() {
+    //     UBERSHADER  DEFERRED:    ,  ,   
+    if (renderMode != RenderMode::UBERSHADER && renderMode != RenderMode::DEFERRED) {
+        return;
+    }
+    if (batchOrder.empty()) {
+        buildUberBatches();
+    }
+
+    size_t blocks = countInstanceBatches(false);
+    if (renderStats.impostors > 0) {
+        blocks += countInstanceBatches(true);
+    }
+
+    GLsizeiptr required = streamBuffer->uniformSpan(sizeof(UberInstance) * MAX_UBER_INSTANCES)
+                        * static_cast<GLsizeiptr>(blocks);
+    if (required > streamBuffer->getFrameSize()) {
+        //  ,  ,   ,     
+        GLsizeiptr frameSize = streamBuffer->getFrameSize();
+        while (frameSize < required) {
+            frameSize *= 2;
+        }
+        std::cout << "INFO::SCENE: " << blocks << " instance batches per frame, growing stream buffer region to "
+                  << frameSize / 1024 << " KB." << std::endl;
+        streamBuffer->reserve(frameSize);
+    }
+}
+
+void Scene::drawInstanceBatches(const Shader* impostorShader) {
+    //    (registerMaterials  ) -  
+    if (batchOrder.empty()) {
+        buildUberBatches();
+    }
+
+    bool impostors = impostorShader != nullptr;
+
+    // :            .
+    //        GPU,     .
+    //      ;    ,
+    // ..          
+    const GLsizeiptr instanceBlockSize = sizeof(UberInstance) * MAX_UBER_INSTANCES;
+
+    size_t next = 0;
+    while (next < batchOrder.size()) {
+        //     ,       
+        if (!isInstanceDrawn(batchOrder[next], impostors)) {
+            ++next;
+            continue;
+        }
+
+        const Object& first = *objects[batchOrder[next]];
+        const Mesh* mesh = &first.getMesh();
+        const Texture* texture = first.getMaterial().texture.get();
+
+        //       (reserveInstanceBlocks);     ,
+        //   ,    ,   
+        StreamBuffer::Allocation allocation = streamBuffer->allocateUniform(instanceBlockSize);
+        UberInstance* instances = static_cast<UberInstance*>(allocation.data);
+        if (!instances) {
+            overflowInstances.resize(MAX_UBER_INSTANCES);
+            instances = overflowInstances.data();
+        }
+
+        int count = 0;
+        while (next < batchOrder.size() && count < MAX_UBER_INSTANCES) {
+            size_t index = batchOrder[next];
+            const Object& object = *objects[index];
+            if (&object.getMesh() != mesh || object.getMaterial().texture.get() != texture) {
+                break;
+            }
+            if (!isInstanceDrawn(index, impostors)) {
+                ++next;
+                continue;
+            }
+            std::memcpy(instances[count].model, object.getModelMatrixData(), sizeof(instances[count].model));
+            instances[count].materialIndex = objectMaterialIndices[index];
+            instances[count].culledLights = objectCulledLights[index];
+            instances[count].impostorFade = objectImpostorFade[index];
+            instances[count].pad = 0;
+            ++count;
+            ++next;
+        }
+
+        if (allocation.data) {
+            streamBuffer->flush(allocation);
+            streamBuffer->bindRange(INSTANCE_BLOCK_BINDING, allocation);
+        }
+        else {
+            streamBuffer->uploadOverflow(INSTANCE_BLOCK_BINDING, instances, instanceBlockSize);
+        }
+        if (impostors) {
+            //    selectImpostors;     
+            const ImpostorAtlas::Impostor* impostor = impostorAtlas->find(*mesh, texture);
+            if (!impostor) {
+                continue;
+            }
+            impostorAtlas->bind(*impostor);
+            impostorShader->setArray(impostorShader->standardUniforms().impostor.bounds, impostor->bounds, 1);
+            impostorAtlas->drawBillboards(count);
+        }
+        else {
+            if (texture) {
+                texture->bind(0);
+            }
+            mesh->drawInstanced(count);
+        }
+        renderStats.drawCalls++;
+    }
+}
+
+void Scene::drawImpostors(bool geometryPass) {
+    if (renderStats.impostors == 0) {
+        return;
+    }
+
+    //         ,   :   
+    Shader& shader = geometryPass ? shaderManager.getImpostorGeometryPassShader()
+                                  : shaderManager.getImpostorShader(clusteredFrame);
+    shader.use();
+    renderStats.programSwitches++;
+    setProgramConstants(shader);
+    drawInstanceBatches(&shader);
+}
+
+size_t Scene::selectImpostors(const Camera& camera, const float* projMatrix) {
+    objectImpostorFade.assign(objects.size(), 0.0f);
+
+    //    :  PER_MODEL  GPU_DRIVEN   
+    bool batched = renderMode == RenderMode::UBERSHADER || renderMode == RenderMode::DEFERRED;
+    if (impostorThreshold <= 0.0f || !batched) {
+        return 0;
+    }
+
+    //    : 2r / (2 * d * tan(fov / 2)) *  = r * projMatrix[5] *  / d
+    float pixelsPerUnit = projMatrix[5] * static_cast<float>(renderGraph->getTargetViewport()[3]);
+    float meshSize = impostorThreshold * (1.0f + IMPOSTOR_FADE_BAND);
+    float fadeRange = impostorThreshold * IMPOSTOR_FADE_BAND;
+
+    size_t count = 0;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!objectVisible[i] || objectMaterialIndices[i] < 0) {
+            continue;
+        }
+
+        const Object& object = *objects[i];
+        Vec3 center(0.0f, 0.0f, 0.0f);
+        float radius = 0.0f;
+        object.getWorldBoundingSphere(center, radius);
+        Vec3 offset = center - camera.Position;
+        float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+        if (distance <= radius || object.getMesh().getBounds().radius <= 0.0f) {
+            continue;
+        }
+
+        float fade = std::clamp((meshSize - radius * pixelsPerUnit / distance) / fadeRange, 0.0f, 1.0f);
+        if (fade <= 0.0f) {
+            continue;
+        }
+
+        //   (, )    -      
+        if (!impostorAtlas) {
+            impostorAtlas = std::make_unique<ImpostorAtlas>();
+        }
+        impostorAtlas->acquire(object.getMesh(), object.getMaterial().texture.get(), shaderManager.getImpostorBakeShader());
+        objectImpostorFade[i] = fade;
+        count++;
+    }
+    return count;
+}
+
+void Scene::addIndirectCullingPass(const Frustum& frustum) {
+    if (batchOrder.empty()) {
+        buildUberBatches();
+    }
+
+    //     (  );   GPU
+    indirectRenderer->beginFrame();
+    for (size_t index : batchOrder) {
+        const Object& object = *objects[index];
+        indirectRenderer->addObject(object.getMesh(), object.getMaterial().texture.get(), object.getModelMatrixData(),
+                                    objectMaterialIndices[index], objectCulledLights[index]);
+    }
+
+    //     :   -  ,     
+    renderGraph->addPass("IndirectCulling",
+        [](RenderGraph::PassBuilder& builder) {
+            builder.setSideEffect();
+        },
+        [this, frustum](const RenderGraph::PassContext&) {
+            indirectRenderer->cull(shaderManager.getIndirectCullShader(), frustum);
+        });
+}
+
+void Scene::renderIndirect() {
+    //     ,    
+    Shader& shader = shaderManager.getIndirectDrawShader(clusteredFrame);
+    shader.use();
+    renderStats.programSwitches++;
+    setProgramConstants(shader);
+
+    indirectRenderer->draw(shader);
+    renderStats.drawCalls += indirectRenderer->getStats().multiDrawCalls;
+    renderStats.indirectCommands = indirectRenderer->getStats().objects;
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+void Scene::setOcclusionCulling(bool enabled) {
+    if (!enabled && occlusionCulling) {
+        occlusionCuller->printObjectStats(10);
+    }
+
+    occlusionCulling = enabled;
+    std::cout << "INFO::SCENE: Occlusion culling " << (enabled ? "enabled" : "disabled") << "." << std::endl;
+}
+
+void Scene::setClusteredLighting(bool enabled) {
+    clusteredLighting = enabled;
+    std::cout << "INFO::SCENE: Clustered lighting " << (enabled ? "forced on" : "automatic") << "." << std::endl;
+}
+
+void Scene::setAntialiasing(AntialiasingMode mode) {
+    //      - :     
+    GLint maxColorSamples = 0;
+    GLint maxDepthSamples = 0;
+    glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &maxColorSamples);
+    glGetIntegerv(GL_MAX_DEPTH_TEXTURE_SAMPLES, &maxDepthSamples);
+    int maxSamples = std::min(maxColorSamples, maxDepthSamples);
+
+    AntialiasingMode requested = mode;
+    while (antialiasingSamples(mode) > maxSamples) {
+        mode = static_cast<AntialiasingMode>(static_cast<int>(mode) - 1);
+    }
+    if (mode != requested) {
+        std::cout << "WARNING::SCENE: " << antialiasingModeName(requested) << " is not supported (max "
+                  << maxSamples << " samples), using " << antialiasingModeName(mode) << "." << std::endl;
+    }
+
+    antialiasing = mode;
+    std::cout << "INFO::SCENE: Antialiasing: " << antialiasingModeName(mode) << "." << std::endl;
+    if (renderMode == RenderMode::DEFERRED && antialiasingSamples(mode) > 1) {
+        std::cout << "WARNING::SCENE: MSAA has no effect in DEFERRED mode (single-sample G-buffer)." << std::endl;
+    }
+}
+
+void Scene::setRenderScale(float scale) {
+    renderScale = std::clamp(scale, MIN_RENDER_SCALE, 1.0f);
+}
+
+void Scene::setImpostorThreshold(float pixels) {
+    impostorThreshold = std::max(pixels, 0.0f);
+    if (impostorThreshold > 0.0f) {
+        std::cout << "INFO::SCENE: Impostors below " << impostorThreshold << " px on screen." << std::endl;
+    }
+    else {
+        std::cout << "INFO::SCENE: Impostors disabled." << std::endl;
+    }
+    if (impostorThreshold > 0.0f && (renderMode == RenderMode::PER_MODEL || renderMode == RenderMode::GPU_DRIVEN)) {
+        std::cout << "INFO::SCENE: Impostors are drawn only in UBERSHADER and DEFERRED modes." << std::endl;
+    }
+}
+
+void Scene::setMaxLightsPerCluster(size_t count) {
+    lightClusters->setMaxLightsPerCluster(count);
+}
+
+size_t Scene::getMaxLightsPerCluster() const {
+    return lightClusters->getMaxLightsPerCluster();
+}
+
+void Scene::addLight(std::shared_ptr<Light> light) {
+    lights.push_back(std::move(light));
+}
 
-        // 5.   (     )
-        object->draw(currentShader);
+void Scene::addLanternRing() {
+    //      ;    -     
+    const Vec3 lanternColors[4] = {
+        Vec3(0.5f, 0.2f, 0.1f), Vec3(0.1f, 0.4f, 0.5f), Vec3(0.4f, 0.4f, 0.1f), Vec3(0.3f, 0.1f, 0.5f)
+    };
+    float radius = 4.5f + 1.5f * lanternRings;
+    for (int i = 0; i < LANTERNS_PER_RING; ++i) {
+        float angle = glm::radians(360.0f * (i + 0.5f * lanternRings) / LANTERNS_PER_RING);
+        addLight(std::make_shared<PointLight>(
+            sf::Vector3f(1.0f + radius * std::cos(angle), 0.3f, -1.0f + radius * std::sin(angle)),
+            lanternColors[i % 4],
+            1.0f, 0.35f, 8.0f                 //  ~4 ( LightClusters::ATTENUATION_CUTOFF)
+        ));
     }
+    lanternRings++;
+
+    std::cout << "INFO::SCENE: Added lantern ring " << lanternRings << " (" << lights.size() << " lights)." << std::endl;
+}
+
+void Scene::setSoftwareOcclusion(bool enabled) {
+    softwareOcclusion = enabled;
+    std::cout << "INFO::SCENE: Software occlusion culling " << (enabled ? "enabled" : "disabled") << "." << std::endl;
+}
+
+void Scene::setRenderMode(RenderMode mode) {
+    if (mode == RenderMode::GPU_DRIVEN && !IndirectRenderer::isSupported()) {
+        std::cout << "WARNING::SCENE: GPU_DRIVEN requires OpenGL 4.3 and ARB_shader_draw_parameters, using UBERSHADER." << std::endl;
+        mode = RenderMode::UBERSHADER;
+    }
+    if (mode == RenderMode::GPU_DRIVEN && !indirectRenderer) {
+        indirectRenderer = std::make_unique<IndirectRenderer>();
+    }
+    if (mode != RenderMode::PER_MODEL) {
+        buildUberBatches();
+    }
+
+    renderMode = mode;
+    std::cout << "INFO::SCENE: Render mode: " << renderModeName(mode) << std::endl;
+    if (mode == RenderMode::GPU_DRIVEN && (softwareOcclusion || occlusionCulling)) {
+        std::cout << "INFO::SCENE: GPU_DRIVEN culls by frustum on the GPU, occlusion culling is not applied." << std::endl;
+    }
+    if (mode == RenderMode::DEFERRED && antialiasingSamples(antialiasing) > 1) {
+        std::cout << "WARNING::SCENE: MSAA has no effect in DEFERRED mode (single-sample G-buffer)." << std::endl;
+    }
+}
+
+void Scene::registerMaterials() {
+    //             
+    objectMaterialIndices.assign(objects.size(), -1);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i]->isDrawable()) {
+            objectMaterialIndices[i] = materialTable->registerMaterial(objects[i]->getMaterial());
+        }
+    }
+
+    //      -  
+    batchOrder.clear();
+}
+
+void Scene::buildUberBatches() {
+    if (objectMaterialIndices.size() != objects.size()) {
+        registerMaterials();
+    }
+
+    // 1.     
+    batchOrder.clear();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objectMaterialIndices[i] >= 0) {
+            batchOrder.push_back(i);
+        }
+    }
+
+    // 2.   ,    (   ).
+    //   -  (, );  GPU_DRIVEN     
+    std::stable_sort(batchOrder.begin(), batchOrder.end(), [this](size_t a, size_t b) {
+        const void* textureA = objects[a]->getMaterial().texture.get();
+        const void* textureB = objects[b]->getMaterial().texture.get();
+        if (textureA != textureB) {
+            return std::less<const void*>()(textureA, textureB);
+        }
+        return std::less<const void*>()(&objects[a]->getMesh(), &objects[b]->getMesh());
+    });
+
+    //    GPU_DRIVEN     
+    if (indirectRenderer) {
+        indirectRenderer->clearGeometry();
+    }
+
+    std::cout << "INFO::SCENE: Uber shader batches: " << materialTable->size() << " materials, "
+              << batchOrder.size() << " objects." << std::endl;
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+ShaderVariantKey Scene::makeLightingKey() const {
+    ShaderVariantKey key;
+    key.dirLight = false;
+
+    int pointLightCount = 0;
+    int spotLightCount = 0;
+    for (const auto& light : lights) {
+        if (std::dynamic_pointer_cast<DirectionalLight>(light)) {
+            key.dirLight = true;
+        }
+        else if (std::dynamic_pointer_cast<PointLight>(light)) {
+            pointLightCount++;
+        }
+        else if (std::dynamic_pointer_cast<SpotLight>(light)) {
+            spotLightCount++;
+        }
+    }
+
+    // ,      (. updateFrameUniforms),   ;
+    //    ,       
+    key.clustered = clusteredLighting || pointLightCount > MAX_POINT_LIGHTS || spotLightCount > MAX_SPOT_LIGHTS;
+    if (!key.clustered) {
+        key.numPointLights = pointLightCount;
+        key.numSpotLights = spotLightCount;
+    }
+    return key;
+}
+
+ShaderVariantKey Scene::makeVariantKey(const Material& material, const ShaderVariantKey& lightingKey) const {
+    ShaderVariantKey key = lightingKey;
+    key.model = material.getLightingModel();
+    key.textured = material.hasTexture();
+    key.specular = material.hasSpecular();
+    return key;
 }
 
 // ----------------------------------------------------------------------
@@ -1,4 +1,6 @@
 #include "../include/Shader.h"
+#include "../include/GLStateCache.h"
+#include "../include/ProgramBinaryCache.h"
 #include <stdexcept>
 #include <cstring> //  memcpy,     GLM
 
@@ -6,7 +8,8 @@
 //   
 // ----------------------------------------------------------------------
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
+Shader::Shader(const char* vertexPath, const char* fragmentPath, ProgramBinaryCache* binaryCache,
+               const std::string& defines, bool asynchronous) {
     // 1.      
     std::string vertexCode;
     std::string fragmentCode;
@@ -30,47 +33,229 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
         vShaderFile.close();
         fShaderFile.close();
 
-        //    
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        //     ( #define ,   )
+        vertexCode = injectDefines(vShaderStream.str(), defines);
+        fragmentCode = injectDefines(fShaderStream.str(), defines);
     }
     catch (std::ifstream::failure& e) {
         std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << vertexPath << " or " << fragmentPath << std::endl;
         //   ,   
         throw std::runtime_error("Shader file reading error.");
     }
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
+    ID = glCreateProgram();
 
-    // 2.  
-    unsigned int vertex, fragment;
+    // 2.        (   )
+    std::string cacheKey;
+    if (binaryCache && binaryCache->isSupported()) {
+        cacheKey = binaryCache->makeKey({ vertexCode, fragmentCode });
+        if (binaryCache->load(cacheKey, ID)) {
+            bindUniformBlocks();
+            buildUniformTable();
+            resolveStandardUniforms();
+            return;
+        }
+        //      -   
+    }
 
-    //  
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
+    // 3.    (   completeBuild)
+    submitBuild({ { GL_VERTEX_SHADER, vertexCode }, { GL_FRAGMENT_SHADER, fragmentCode } }, binaryCache, cacheKey);
+    if (!asynchronous) {
+        completeBuild();
+    }
+}
 
-    //  
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+Shader::Shader(ShaderStage stage, const char* path, ProgramBinaryCache* binaryCache,
+               const std::string& defines, bool asynchronous)
+    : separable(stage != ShaderStage::COMPUTE)
+{
+    // 1.    
+    std::string code;
+    std::ifstream shaderFile;
+    shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    try {
+        shaderFile.open(path);
+        std::stringstream shaderStream;
+        shaderStream << shaderFile.rdbuf();
+        shaderFile.close();
+        code = injectDefines(shaderStream.str(), defines);
+    }
+    catch (std::ifstream::failure& e) {
+        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+        throw std::runtime_error("Shader file reading error.");
+    }
 
-    // 3.   
+    GLenum glStage = (stage == ShaderStage::VERTEX) ? GL_VERTEX_SHADER
+                   : (stage == ShaderStage::FRAGMENT) ? GL_FRAGMENT_SHADER : GL_COMPUTE_SHADER;
+    const char* stageName = (stage == ShaderStage::VERTEX) ? "VERTEX"
+                          : (stage == ShaderStage::FRAGMENT) ? "FRAGMENT" : "COMPUTE";
+
+    // 2. ,     ,     separable  
+    // (      glUseProgram)
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    if (separable) {
+        glProgramParameteri(ID, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    }
+
+    // 3.      (    )
+    std::string cacheKey;
+    if (binaryCache && binaryCache->isSupported()) {
+        cacheKey = binaryCache->makeKey({ code }, std::string(separable ? "SEPARABLE_" : "") + stageName);
+        if (binaryCache->load(cacheKey, ID)) {
+            // Uniform-    glProgramUniform*
+            bindUniformBlocks();
+            buildUniformTable(separable);
+            resolveStandardUniforms();
+            return;
+        }
+    }
+
+    // 4.   
+    submitBuild({ { glStage, code } }, binaryCache, cacheKey);
+    if (!asynchronous) {
+        completeBuild();
+    }
+}
+
+Shader::Shader(GLuint pipeline, std::shared_ptr<Shader> vertex, std::shared_ptr<Shader> fragment)
+    : ID(0), pipelineID(pipeline), vertexStage(std::move(vertex)), fragmentStage(std::move(fragment))
+{
+    if (!vertexStage || !fragmentStage) {
+        throw std::runtime_error("ERROR::SHADER: Pipeline requires both vertex and fragment stages.");
+    }
+
+    //    :     isReady()
+    ready = vertexStage->ready && fragmentStage->ready;
+    if (ready) {
+        mergeStageUniforms();
+    }
+}
+
+Shader::~Shader() {
+    for (const auto& pending : pendingShaders) {
+        glDeleteShader(pending.shader);
+    }
+
+    //    ID == 0:    
+    if (ID != 0) {
+        GLStateCache::get().forgetProgram(ID);
+        glDeleteProgram(ID);
+    }
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+bool Shader::isReady() {
+    if (ready || failed) {
+        return ready;
+    }
+
+    if (pipelineID != 0) {
+        //      (     )
+        bool stagesReady = vertexStage->isReady() && fragmentStage->isReady();
+        if (!stagesReady) {
+            failed = vertexStage->hasFailed() || fragmentStage->hasFailed();
+            return false;
+        }
+        mergeStageUniforms();
+        ready = true;
+        return true;
+    }
+
+    if (GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile) {
+        //   :   /   
+        GLint completed = GL_FALSE;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &completed);
+        if (!completed) {
+            return false;
+        }
+    }
+
+    completeBuild();
+    return true;
+}
+
+void Shader::finish() {
+    if (ready) {
+        return;
+    }
+    if (failed) {
+        throw std::runtime_error("ERROR::SHADER: Program build has failed.");
+    }
+
+    if (pipelineID != 0) {
+        vertexStage->finish();
+        fragmentStage->finish();
+        mergeStageUniforms();
+        ready = true;
+        return;
+    }
+    completeBuild();
+}
+
+void Shader::submitBuild(const std::vector<std::pair<GLenum, std::string>>& sources,
+                         ProgramBinaryCache* binaryCache, const std::string& cacheKey) {
+    //    :      
+    for (const auto& source : sources) {
+        const char* code = source.second.c_str();
+        GLuint shader = glCreateShader(source.first);
+        glShaderSource(shader, 1, &code, NULL);
+        glCompileShader(shader);
+        glAttachShader(ID, shader);
+        pendingShaders.push_back({ shader, source.first == GL_VERTEX_SHADER ? "VERTEX"
+                                         : source.first == GL_FRAGMENT_SHADER ? "FRAGMENT" : "COMPUTE" });
+    }
+
+    if (!cacheKey.empty()) {
+        //    ,   glGetProgramBinary
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        pendingCache = binaryCache;
+        pendingCacheKey = cacheKey;
+    }
     glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
+    ready = false;
+}
+
+void Shader::completeBuild() {
+    try {
+        for (const auto& pending : pendingShaders) {
+            checkCompileErrors(pending.shader, pending.type);
+        }
+        checkCompileErrors(ID, "PROGRAM");
+    }
+    catch (...) {
+        failed = true;
+        throw;
+    }
 
     //    ,    
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    for (const auto& pending : pendingShaders) {
+        glDetachShader(ID, pending.shader);
+        glDeleteShader(pending.shader);
+    }
+    pendingShaders.clear();
+
+    if (pendingCache) {
+        pendingCache->store(pendingCacheKey, ID);
+        pendingCache = nullptr;
+    }
+
+    //   uniform-:  location   
+    bindUniformBlocks();
+    buildUniformTable(separable);
+    resolveStandardUniforms();
+    ready = true;
 }
 
-Shader::~Shader() {
-    glDeleteProgram(ID);
+void Shader::mergeStageUniforms() {
+    //  :      ,    .
+    //      ,    (     ).
+    uniformSlots = vertexStage->uniformSlots;
+    for (const auto& entry : fragmentStage->uniformSlots) {
+        uniformSlots[entry.first] = entry.second;
+    }
+    resolveStandardUniforms();
 }
 
 // ----------------------------------------------------------------------
@@ -78,40 +263,55 @@ Shader::~Shader() {
 // ----------------------------------------------------------------------
 
 void Shader::use() const {
-    glUseProgram(ID);
+    if (pipelineID != 0) {
+        //    ,   .
+        //       -   .
+        //    ,    
+        GLStateCache& state = GLStateCache::get();
+        state.useProgram(0);
+        state.bindProgramPipeline(pipelineID);
+        state.useProgramStages(pipelineID, GL_FRAGMENT_SHADER_BIT, fragmentStage->ID);
+        return;
+    }
+    GLStateCache::get().useProgram(ID);
+}
+
+GLint Shader::getUniformLocation(const std::string& name) const {
+    auto it = uniformSlots.find(name);
+    return (it != uniformSlots.end()) ? it->second.location : -1;
 }
 
 void Shader::setBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    set(uniform<bool>(name), value);
 }
 
 void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    set(uniform<int>(name), value);
 }
 
 void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    set(uniform<float>(name), value);
 }
 
 void Shader::setVec2(const std::string& name, const Vec2& value) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), value.x, value.y);
+    set(uniform<Vec2>(name), value);
 }
 
 void Shader::setVec2(const std::string& name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    set(uniform<Vec2>(name), Vec2(x, y));
 }
 
 void Shader::setVec3(const std::string& name, const Vec3& value) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z);
+    set(uniform<Vec3>(name), value);
 }
 
 void Shader::setVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    set(uniform<Vec3>(name), Vec3(x, y, z));
 }
 
 void Shader::setMat4(const std::string& name, const float* matrixData) const {
     // : GL_FALSE ,     ( )
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, matrixData);
+    set(uniform<Mat4>(name), matrixData);
 }
 
 // ----------------------------------------------------------------------
@@ -139,4 +339,114 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type) {
             throw std::runtime_error("Shader linking failed.");
         }
     }
+}
+
+std::string Shader::injectDefines(const std::string& source, const std::string& defines) {
+    if (defines.empty()) {
+        return source;
+    }
+
+    size_t versionPos = source.find("#version");
+    if (versionPos == std::string::npos) {
+        return defines + source;
+    }
+
+    size_t lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos) {
+        return source + "\n" + defines;
+    }
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
+void Shader::buildUniformTable(bool separable) {
+    uniformSlots.clear();
+    GLuint owner = separable ? ID : 0;
+
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::string nameBuffer(maxNameLength > 0 ? maxNameLength : 1, '\0');
+    for (GLint i = 0; i < uniformCount; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, maxNameLength, &length, &size, &type, &nameBuffer[0]);
+        std::string name(nameBuffer.c_str(), length);
+
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0) {
+            //   uniform-   location
+            continue;
+        }
+        uniformSlots[name] = { location, owner };
+
+        //       "name[0]"  size > 1:
+        //        .
+        // (  ,  "pointLights[1].color",   .)
+        const std::string arraySuffix = "[0]";
+        if (name.size() > arraySuffix.size() &&
+            name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0) {
+            std::string baseName = name.substr(0, name.size() - arraySuffix.size());
+            uniformSlots[baseName] = { location, owner };
+            for (GLint element = 1; element < size; ++element) {
+                std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                uniformSlots[elementName] = { glGetUniformLocation(ID, elementName.c_str()), owner };
+            }
+        }
+    }
+}
+
+void Shader::bindUniformBlocks() {
+    static const std::pair<const char*, GLuint> blocks[] = {
+        { "CameraData", CAMERA_BLOCK_BINDING },
+        { "LightData", LIGHTS_BLOCK_BINDING },
+        { "MaterialData", MATERIAL_BLOCK_BINDING },
+        { "InstanceData", INSTANCE_BLOCK_BINDING },
+        { "ClusterData", CLUSTER_BLOCK_BINDING }
+    };
+
+    //    (,   ) -   GL_INVALID_INDEX
+    for (const auto& block : blocks) {
+        GLuint blockIndex = glGetUniformBlockIndex(ID, block.first);
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(ID, blockIndex, block.second);
+        }
+    }
+}
+
+void Shader::resolveStandardUniforms() {
+    standard.model = uniform<Mat4>("model");
+    standard.culledLights = uniform<int>("culledLights");
+
+    standard.material.index = uniform<int>("materialIndex");
+    standard.material.textureDiffuse = uniform<int>("texture_diffuse1");
+
+    standard.lookupTables.orenNayar = uniform<int>("orenNayarLUT");
+    standard.lookupTables.toonRamp = uniform<int>("toonRampLUT");
+
+    standard.clusters.lights = uniform<int>("clusterLights");
+    standard.clusters.ranges = uniform<int>("clusterRanges");
+    standard.clusters.indices = uniform<int>("clusterLightIndices");
+
+    standard.gBuffer.position = uniform<int>("gPosition");
+    standard.gBuffer.normal = uniform<int>("gNormal");
+    standard.gBuffer.albedo = uniform<int>("gAlbedo");
+    standard.gBuffer.depth = uniform<int>("gDepth");
+
+    standard.postProcess.sceneColor = uniform<int>("sceneColor");
+    standard.postProcess.sampleCount = uniform<int>("sampleCount");
+    standard.postProcess.targetOrigin = uniform<Vec2>("targetOrigin");
+    standard.postProcess.targetSize = uniform<Vec2>("targetSize");
+
+    standard.indirect.frustumPlanes = uniform<Vec4>("frustumPlanes");
+    standard.indirect.objectCount = uniform<int>("objectCount");
+    standard.indirect.drawBase = uniform<int>("drawBase");
+
+    standard.impostor.albedo = uniform<int>("impostorAlbedo");
+    standard.impostor.normalDepth = uniform<int>("impostorNormalDepth");
+    standard.impostor.bounds = uniform<Vec4>("impostorBounds");
+    standard.impostor.bakeViewProjection = uniform<Mat4>("bakeViewProjection");
+    standard.impostor.bakeTextured = uniform<int>("bakeTextured");
 }
\ No newline at end of file
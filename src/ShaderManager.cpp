@@ -1,39 +1,126 @@
 #include "../include/ShaderManager.h"
+#include "../include/GLStateCache.h"
+#include <algorithm>
 #include <iostream>
 
-ShaderManager::ShaderManager() {
-    // 
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+uint32_t ShaderVariantKey::packed() const {
+    // [0..7]  | [8..11]  | [12..15]  | 16 dir | 17  | 18  | 19 
+    return static_cast<uint32_t>(model)
+        | (static_cast<uint32_t>(numPointLights) << 8)
+        | (static_cast<uint32_t>(numSpotLights) << 12)
+        | (dirLight ? 1u << 16 : 0u)
+        | (textured ? 1u << 17 : 0u)
+        | (specular ? 1u << 18 : 0u)
+        | (clustered ? 1u << 19 : 0u);
+}
+
+std::string ShaderVariantKey::defines() const {
+    std::string result;
+    result += "#define NUM_POINT_LIGHTS " + std::to_string(numPointLights) + "\n";
+    result += "#define NUM_SPOT_LIGHTS " + std::to_string(numSpotLights) + "\n";
+    if (!dirLight) result += "#define NO_DIR_LIGHT\n";
+    if (!textured) result += "#define NO_TEXTURE\n";
+    if (!specular) result += "#define NO_SPECULAR\n";
+    if (clustered) result += "#define CLUSTERED_LIGHTING\n";
+    return result;
+}
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+ShaderManager::ShaderManager(AssetRegistry& registry)
+    : assetRegistry(registry), binaryCache("shader_cache"), pipeline(0)
+{
 }
 
+ShaderManager::~ShaderManager() {
+    //     ,    
+    pendingPrograms.clear();
+    variants.clear();
+    shaders.clear();
+    uberShader.reset();
+    clusteredUberShader.reset();
+    fallbackShader.reset();
+    occlusionShader.reset();
+    geometryPassShader.reset();
+    lightingPassShader.reset();
+    clusteredLightingPassShader.reset();
+    fxaaShader.reset();
+    msaaResolveShader.reset();
+    upscaleShader.reset();
+    indirectCullShader.reset();
+    indirectDrawShader.reset();
+    clusteredIndirectDrawShader.reset();
+    impostorBakeShader.reset();
+    impostorShader.reset();
+    clusteredImpostorShader.reset();
+    impostorGeometryPassShader.reset();
+    baseVertexStage.reset();
+    if (pipeline != 0) {
+        GLStateCache::get().forgetProgramPipeline(pipeline);
+        glDeleteProgramPipelines(1, &pipeline);
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
 void ShaderManager::loadAllShaders() {
     std::cout << "INFO::SHADER_MANAGER: Loading all shaders..." << std::endl;
+    buildStart = std::chrono::steady_clock::now();
 
     try {
-        // 1.  Phong
-        //      phong.frag
-        shaders[LightingModel::PHONG] = std::make_unique<Shader>(
-            BASE_VERTEX_PATH.c_str(),
-            "src/res/shaders/phong.frag"
-        );
-        std::cout << "  - Loaded PHONG shader." << std::endl;
-
-        // 2. Toon Shading
-        //      toon.frag
-        shaders[LightingModel::TOON_SHADING] = std::make_unique<Shader>(
-            BASE_VERTEX_PATH.c_str(),
-            "src/res/shaders/toon.frag"
-        );
-        std::cout << "  - Loaded TOON SHADING shader." << std::endl;
-
-        // 3.   (CUSTOM_MODEL)
-        // , Cook-Torrance  Oren-Nayar.
-        //      custom.frag
-        shaders[LightingModel::CUSTOM_MODEL] = std::make_unique<Shader>(
-            BASE_VERTEX_PATH.c_str(),
-            "src/res/shaders/custom.frag"
-        );
-        std::cout << "  - Loaded CUSTOM MODEL shader." << std::endl;
+        // 0.    :       ,
+        //      
+        fallbackShader = assetRegistry.loadShader(BASE_VERTEX_PATH, FALLBACK_FRAGMENT_PATH, &binaryCache);
+        std::cout << "  - Loaded FALLBACK shader." << std::endl;
+
+        // -  :    ,  
+        occlusionShader = assetRegistry.loadShader(BASE_VERTEX_PATH, OCCLUSION_FRAGMENT_PATH, &binaryCache);
+        std::cout << "  - Loaded OCCLUSION shader." << std::endl;
 
+        if (GLEW_KHR_parallel_shader_compile) {
+            //      ,    
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+            std::cout << "  - Using parallel shader compilation (KHR_parallel_shader_compile)." << std::endl;
+        }
+        else if (GLEW_ARB_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+            std::cout << "  - Using parallel shader compilation (ARB_parallel_shader_compile)." << std::endl;
+        }
+
+        // 1.   ARB_separate_shader_objects base.vert   
+        //      ;      .
+        //    ,     (. acquireReady).
+        if (GLEW_ARB_separate_shader_objects) {
+            baseVertexStage = assetRegistry.loadShaderStage(ShaderStage::VERTEX, BASE_VERTEX_PATH, &binaryCache, "", true);
+            glGenProgramPipelines(1, &pipeline);
+            std::cout << "  - Using separable program pipeline (shared base.vert)." << std::endl;
+        }
+
+        // 2.  :     ,   .
+        // Phong, Toon    (Oren-Nayar)    .
+        fragmentPaths[LightingModel::PHONG] = "src/res/shaders/phong.frag";
+        fragmentPaths[LightingModel::TOON_SHADING] = "src/res/shaders/toon.frag";
+        fragmentPaths[LightingModel::CUSTOM_MODEL] = "src/res/shaders/custom.frag";
+        for (const auto& entry : fragmentPaths) {
+            shaders[entry.first] = loadLightingShader(entry.second);
+            pendingPrograms.push_back(shaders[entry.first]);
+        }
+        std::cout << "  - Submitted PHONG, TOON SHADING and CUSTOM MODEL shaders." << std::endl;
+
+        // 3.  (    ,   )
+        //     ,    ( separable) 
+        uberShader = assetRegistry.loadShader("src/res/shaders/uber.vert", "src/res/shaders/uber.frag",
+                                              &binaryCache, "", true);
+        pendingPrograms.push_back(uberShader);
+        std::cout << "  - Submitted UBER shader." << std::endl;
     }
     catch (const std::exception& e) {
         //        (,   ),
@@ -43,7 +130,235 @@ void ShaderManager::loadAllShaders() {
         throw;
     }
 
-    std::cout << "INFO::SHADER_MANAGER: All shaders successfully loaded." << std::endl;
+    allReadyReported = false;
+    std::cout << "INFO::SHADER_MANAGER: Shaders submitted, fallback shader is used until they are ready." << std::endl;
+}
+
+std::shared_ptr<Shader> ShaderManager::loadLightingShader(const std::string& fragmentPath, const std::string& defines) {
+    if (pipeline != 0) {
+        auto fragmentStage = assetRegistry.loadShaderStage(ShaderStage::FRAGMENT, fragmentPath, &binaryCache, defines, true);
+        return std::make_shared<Shader>(pipeline, baseVertexStage, fragmentStage);
+    }
+
+    //  :      
+    return assetRegistry.loadShader(BASE_VERTEX_PATH, fragmentPath, &binaryCache, defines, true);
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+bool ShaderManager::acquireReady(const std::shared_ptr<Shader>& shader) {
+    bool ready = false;
+    try {
+        ready = shader->isReady();
+    }
+    catch (const std::exception& e) {
+        //    ;        
+        std::cerr << "ERROR::SHADER_MANAGER: Program build failed, keeping fallback: " << e.what() << std::endl;
+        return false;
+    }
+
+    if (ready && shader->isPipeline() && !vertexStageBound) {
+        //   - ,     
+        GLStateCache::get().useProgramStages(pipeline, GL_VERTEX_SHADER_BIT, baseVertexStage->ID);
+        vertexStageBound = true;
+    }
+    return ready;
+}
+
+void ShaderManager::update() {
+    //    (   KHR_parallel_shader_compile)
+    pendingPrograms.erase(std::remove_if(pendingPrograms.begin(), pendingPrograms.end(),
+        [this](const std::shared_ptr<Shader>& shader) {
+            return acquireReady(shader) || shader->hasFailed();
+        }), pendingPrograms.end());
+
+    if (!pendingPrograms.empty() || allReadyReported) {
+        return;
+    }
+    allReadyReported = true;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart);
+    std::cout << "INFO::SHADER_MANAGER: All shader programs ready in " << elapsed.count() << " ms ("
+              << variants.size() << " variants)." << std::endl;
+
+    const ProgramBinaryCache::Stats& cacheStats = binaryCache.getStats();
+    std::cout << "INFO::SHADER_MANAGER: Program cache: " << cacheStats.hits << " hits, "
+              << cacheStats.misses << " misses, " << cacheStats.rejected << " rejected, "
+              << cacheStats.stored << " stored." << std::endl;
+}
+
+void ShaderManager::finishAll() {
+    for (const auto& shader : pendingPrograms) {
+        try {
+            shader->finish();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "ERROR::SHADER_MANAGER: Program build failed, keeping fallback: " << e.what() << std::endl;
+        }
+    }
+    update();
+}
+
+Shader& ShaderManager::getUberShader(bool clustered) {
+    if (!uberShader) {
+        throw std::runtime_error("ERROR::SHADER_MANAGER: Uber shader is not loaded.");
+    }
+
+    if (clustered) {
+        //   ,   ,    LightData
+        if (!clusteredUberShader) {
+            clusteredUberShader = assetRegistry.loadShader("src/res/shaders/uber.vert", "src/res/shaders/uber.frag",
+                                                           &binaryCache, "#define CLUSTERED_LIGHTING\n");
+            std::cout << "INFO::SHADER_MANAGER: Loaded clustered UBER shader." << std::endl;
+        }
+        return *clusteredUberShader;
+    }
+
+    //    ( )    
+    uberShader->finish();
+    return *uberShader;
+}
+
+Shader& ShaderManager::getOcclusionShader() {
+    if (!occlusionShader) {
+        throw std::runtime_error("ERROR::SHADER_MANAGER: Occlusion shader is not loaded.");
+    }
+    return *occlusionShader;
+}
+
+Shader& ShaderManager::getGeometryPassShader() {
+    if (!geometryPassShader) {
+        geometryPassShader = assetRegistry.loadShader("src/res/shaders/uber.vert", GBUFFER_FRAGMENT_PATH, &binaryCache);
+        std::cout << "INFO::SHADER_MANAGER: Loaded G-buffer shader." << std::endl;
+    }
+    return *geometryPassShader;
+}
+
+Shader& ShaderManager::getLightingPassShader(bool clustered) {
+    std::shared_ptr<Shader>& shader = clustered ? clusteredLightingPassShader : lightingPassShader;
+    if (!shader) {
+        shader = assetRegistry.loadShader(DEFERRED_VERTEX_PATH, DEFERRED_FRAGMENT_PATH, &binaryCache,
+                                          clustered ? "#define CLUSTERED_LIGHTING\n" : "");
+        std::cout << "INFO::SHADER_MANAGER: Loaded " << (clustered ? "clustered " : "") << "deferred lighting shader." << std::endl;
+    }
+    return *shader;
+}
+
+Shader& ShaderManager::getAntialiasingShader(bool multisample) {
+    std::shared_ptr<Shader>& shader = multisample ? msaaResolveShader : fxaaShader;
+    if (!shader) {
+        shader = assetRegistry.loadShader(DEFERRED_VERTEX_PATH, multisample ? MSAA_RESOLVE_FRAGMENT_PATH : FXAA_FRAGMENT_PATH,
+                                          &binaryCache);
+        std::cout << "INFO::SHADER_MANAGER: Loaded " << (multisample ? "MSAA resolve" : "FXAA") << " shader." << std::endl;
+    }
+    return *shader;
+}
+
+Shader& ShaderManager::getUpscaleShader() {
+    if (!upscaleShader) {
+        upscaleShader = assetRegistry.loadShader(DEFERRED_VERTEX_PATH, UPSCALE_FRAGMENT_PATH, &binaryCache);
+        std::cout << "INFO::SHADER_MANAGER: Loaded upscale shader." << std::endl;
+    }
+    return *upscaleShader;
+}
+
+Shader& ShaderManager::getIndirectCullShader() {
+    if (!indirectCullShader) {
+        indirectCullShader = assetRegistry.loadShaderStage(ShaderStage::COMPUTE, INDIRECT_CULL_COMPUTE_PATH, &binaryCache);
+        std::cout << "INFO::SHADER_MANAGER: Loaded indirect culling shader." << std::endl;
+    }
+    return *indirectCullShader;
+}
+
+Shader& ShaderManager::getIndirectDrawShader(bool clustered) {
+    std::shared_ptr<Shader>& shader = clustered ? clusteredIndirectDrawShader : indirectDrawShader;
+    if (!shader) {
+        shader = assetRegistry.loadShader(INDIRECT_VERTEX_PATH, "src/res/shaders/uber.frag", &binaryCache,
+                                          clustered ? "#define CLUSTERED_LIGHTING\n" : "");
+        std::cout << "INFO::SHADER_MANAGER: Loaded " << (clustered ? "clustered " : "") << "indirect draw shader." << std::endl;
+    }
+    return *shader;
+}
+
+Shader& ShaderManager::getImpostorBakeShader() {
+    if (!impostorBakeShader) {
+        impostorBakeShader = assetRegistry.loadShader(IMPOSTOR_BAKE_VERTEX_PATH, IMPOSTOR_BAKE_FRAGMENT_PATH, &binaryCache);
+        std::cout << "INFO::SHADER_MANAGER: Loaded impostor bake shader." << std::endl;
+    }
+    return *impostorBakeShader;
+}
+
+Shader& ShaderManager::getImpostorShader(bool clustered) {
+    std::shared_ptr<Shader>& shader = clustered ? clusteredImpostorShader : impostorShader;
+    if (!shader) {
+        shader = assetRegistry.loadShader(IMPOSTOR_VERTEX_PATH, "src/res/shaders/uber.frag", &binaryCache,
+                                          clustered ? "#define IMPOSTOR\n#define CLUSTERED_LIGHTING\n" : "#define IMPOSTOR\n");
+        std::cout << "INFO::SHADER_MANAGER: Loaded " << (clustered ? "clustered " : "") << "impostor shader." << std::endl;
+    }
+    return *shader;
+}
+
+Shader& ShaderManager::getImpostorGeometryPassShader() {
+    if (!impostorGeometryPassShader) {
+        impostorGeometryPassShader = assetRegistry.loadShader(IMPOSTOR_VERTEX_PATH, GBUFFER_FRAGMENT_PATH, &binaryCache,
+                                                              "#define IMPOSTOR\n");
+        std::cout << "INFO::SHADER_MANAGER: Loaded impostor G-buffer shader." << std::endl;
+    }
+    return *impostorGeometryPassShader;
+}
+
+// ----------------------------------------------------------------------
+//  
+// ----------------------------------------------------------------------
+
+Shader& ShaderManager::getShader(const ShaderVariantKey& requested) {
+    //       ,     
+    ShaderVariantKey key = requested;
+    key.numPointLights = std::clamp(key.numPointLights, 0, MAX_POINT_LIGHTS);
+    key.numSpotLights = std::clamp(key.numSpotLights, 0, MAX_SPOT_LIGHTS);
+
+    uint32_t packedKey = key.packed();
+    auto it = variants.find(packedKey);
+    if (it == variants.end()) {
+        auto pathIt = fragmentPaths.find(key.model);
+        if (pathIt == fragmentPaths.end()) {
+            throw std::runtime_error("ERROR::SHADER_MANAGER: Requested shader model not found in manager.");
+        }
+
+        std::shared_ptr<Shader> variant;
+        try {
+            variant = loadLightingShader(pathIt->second, key.defines());
+            pendingPrograms.push_back(variant);
+            allReadyReported = false;
+            std::cout << "INFO::SHADER_MANAGER: Submitted variant " << pathIt->second
+                      << " (point=" << key.numPointLights << ", spot=" << key.numSpotLights
+                      << ", dir=" << key.dirLight << ", textured=" << key.textured
+                      << ", specular=" << key.specular << ", clustered=" << key.clustered << ")." << std::endl;
+        }
+        catch (const std::exception& e) {
+            //    ,   ,  .
+            //     ,       .
+            std::cerr << "WARNING::SHADER_MANAGER: Variant build failed, using generic shader: " << e.what() << std::endl;
+            variant = shaders.at(key.model);
+        }
+        it = variants.emplace(packedKey, variant).first;
+    }
+
+    //    (    ) -   
+    if (acquireReady(it->second)) {
+        return *(it->second);
+    }
+    return getShader(key.model);
+}
+
+void ShaderManager::precompileVariants(const std::vector<ShaderVariantKey>& keys) {
+    //  :    update()    
+    for (const auto& key : keys) {
+        getShader(key);
+    }
+    std::cout << "INFO::SHADER_MANAGER: " << variants.size() << " shader variants submitted." << std::endl;
 }
 
 Shader& ShaderManager::getShader(LightingModel model) {
@@ -53,6 +368,11 @@ Shader& ShaderManager::getShader(LightingModel model) {
         throw std::runtime_error("ERROR::SHADER_MANAGER: Requested shader model not found in manager.");
     }
 
+    //     -  
+    if (!acquireReady(it->second)) {
+        return *fallbackShader;
+    }
+
     //     Shader
     return *(it->second);
 }
\ No newline at end of file
@@ -0,0 +1,414 @@
+#include "../include/SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+// ----------------------------------------------------------------------
+// AABB
+// ----------------------------------------------------------------------
+
+bool AABB::contains(const AABB& other) const {
+    return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+        && max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+}
+
+AABB AABB::merged(const AABB& other) const {
+    AABB result;
+    result.min = Vec3(std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z));
+    result.max = Vec3(std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z));
+    return result;
+}
+
+float AABB::surfaceArea() const {
+    Vec3 d = max - min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+static AABB fattened(const AABB& bounds, float margin) {
+    Vec3 m(margin, margin, margin);
+    return AABB{ bounds.min - m, bounds.max + m };
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+int SpatialIndex::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    int node = freeList;
+    freeList = nodes[node].parent;
+    nodes[node] = Node();
+    return node;
+}
+
+void SpatialIndex::freeNode(int node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+int SpatialIndex::insert(const AABB& bounds, uint32_t userData) {
+    int leaf = allocateNode();
+    nodes[leaf].bounds = fattened(bounds, FAT_MARGIN);
+    nodes[leaf].userData = userData;
+    nodes[leaf].height = 0;
+
+    insertLeaf(leaf);
+    proxyCount++;
+    return leaf;
+}
+
+void SpatialIndex::remove(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool SpatialIndex::move(int proxy, const AABB& bounds) {
+    //   ,   AABB        
+    // (       )
+    const AABB& fat = nodes[proxy].bounds;
+    if (fat.contains(bounds) && fattened(bounds, 4.0f * FAT_MARGIN).contains(fat)) {
+        return false;
+    }
+
+    removeLeaf(proxy);
+    nodes[proxy].bounds = fattened(bounds, FAT_MARGIN);
+    insertLeaf(proxy);
+    return true;
+}
+
+void SpatialIndex::insertLeaf(int leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    //    :        
+    //        (  )
+    AABB leafBounds = nodes[leaf].bounds;
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        float area = node.bounds.surfaceArea();
+        float combinedArea = node.bounds.merged(leafBounds).surfaceArea();
+
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const Node& c = nodes[child];
+            float merged = c.bounds.merged(leafBounds).surfaceArea();
+            return (c.isLeaf() ? merged : merged - c.bounds.surfaceArea()) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = (cost1 < cost2) ? node.child1 : node.child2;
+    }
+
+    int sibling = index;
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].bounds = nodes[sibling].bounds.merged(leafBounds);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        }
+        else {
+            nodes[oldParent].child2 = newParent;
+        }
+    }
+    else {
+        root = newParent;
+    }
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    refitFrom(nodes[leaf].parent);
+}
+
+void SpatialIndex::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+    //     :    
+    if (grandParent != NULL_NODE) {
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        }
+        else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitFrom(grandParent);
+    }
+    else {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void SpatialIndex::refitFrom(int index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = nodes[index];
+        const Node& child1 = nodes[node.child1];
+        const Node& child2 = nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.bounds = child1.bounds.merged(child2.bounds);
+
+        index = node.parent;
+    }
+}
+
+int SpatialIndex::balance(int iA) {
+    Node& A = nodes[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    int iB = A.child1;
+    int iC = A.child2;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+    int difference = C.height - B.height;
+
+    // :    (P)    A, A   ,
+    //     P   A.    .
+    auto rotateUp = [&](int iP, Node& P, int& slotInA) {
+        int iF = P.child1;
+        int iG = P.child2;
+        Node& F = nodes[iF];
+        Node& G = nodes[iG];
+
+        P.child1 = iA;
+        P.parent = A.parent;
+        A.parent = iP;
+
+        if (P.parent != NULL_NODE) {
+            if (nodes[P.parent].child1 == iA) {
+                nodes[P.parent].child1 = iP;
+            }
+            else {
+                nodes[P.parent].child2 = iP;
+            }
+        }
+        else {
+            root = iP;
+        }
+
+        int iKeep = (F.height > G.height) ? iF : iG;
+        int iMove = (F.height > G.height) ? iG : iF;
+        P.child2 = iKeep;
+        slotInA = iMove;
+        nodes[iMove].parent = iA;
+
+        const Node& other = nodes[A.child1 == iMove ? A.child2 : A.child1];
+        A.bounds = other.bounds.merged(nodes[iMove].bounds);
+        A.height = 1 + std::max(other.height, nodes[iMove].height);
+        P.bounds = A.bounds.merged(nodes[iKeep].bounds);
+        P.height = 1 + std::max(A.height, nodes[iKeep].height);
+        return iP;
+    };
+
+    if (difference > 1) {
+        return rotateUp(iC, C, A.child2);
+    }
+    if (difference < -1) {
+        return rotateUp(iB, B, A.child1);
+    }
+    return iA;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void SpatialIndex::collectLeaves(int node, std::vector<uint32_t>& result) const {
+    const Node& n = nodes[node];
+    if (n.isLeaf()) {
+        result.push_back(n.userData);
+        return;
+    }
+    collectLeaves(n.child1, result);
+    collectLeaves(n.child2, result);
+}
+
+void SpatialIndex::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& inside,
+                                std::vector<uint32_t>& intersecting) const {
+    inside.clear();
+    intersecting.clear();
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    //   -    ,     .
+    // ,   ,    .
+    const int allPlanes = (1 << Frustum::PLANE_COUNT) - 1;
+    frustumStack.clear();
+    frustumStack.emplace_back(root, allPlanes);
+
+    while (!frustumStack.empty()) {
+        auto [index, planeMask] = frustumStack.back();
+        frustumStack.pop_back();
+        const Node& node = nodes[index];
+
+        bool outside = false;
+        int remaining = 0;
+        for (int p = 0; p < Frustum::PLANE_COUNT && !outside; ++p) {
+            if (!(planeMask & (1 << p))) {
+                continue;
+            }
+            const float* plane = frustum.planes[p];
+
+            //  (p)   (n)  AABB   
+            float px = plane[0] >= 0.0f ? node.bounds.max.x : node.bounds.min.x;
+            float py = plane[1] >= 0.0f ? node.bounds.max.y : node.bounds.min.y;
+            float pz = plane[2] >= 0.0f ? node.bounds.max.z : node.bounds.min.z;
+            float nx = plane[0] >= 0.0f ? node.bounds.min.x : node.bounds.max.x;
+            float ny = plane[1] >= 0.0f ? node.bounds.min.y : node.bounds.max.y;
+            float nz = plane[2] >= 0.0f ? node.bounds.min.z : node.bounds.max.z;
+
+            if (plane[0] * px + plane[1] * py + plane[2] * pz + plane[3] < 0.0f) {
+                outside = true;
+            }
+            else if (plane[0] * nx + plane[1] * ny + plane[2] * nz + plane[3] < 0.0f) {
+                remaining |= 1 << p;
+            }
+        }
+
+        if (outside) {
+            continue;
+        }
+        if (remaining == 0) {
+            collectLeaves(index, inside);
+        }
+        else if (node.isLeaf()) {
+            intersecting.push_back(node.userData);
+        }
+        else {
+            frustumStack.emplace_back(node.child1, remaining);
+            frustumStack.emplace_back(node.child2, remaining);
+        }
+    }
+}
+
+void SpatialIndex::querySphere(const Vec3& center, float radius, std::vector<uint32_t>& result) const {
+    result.clear();
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+
+        //        AABB
+        float dx = std::max({ node.bounds.min.x - center.x, 0.0f, center.x - node.bounds.max.x });
+        float dy = std::max({ node.bounds.min.y - center.y, 0.0f, center.y - node.bounds.max.y });
+        float dz = std::max({ node.bounds.min.z - center.z, 0.0f, center.z - node.bounds.max.z });
+        if (dx * dx + dy * dy + dz * dz > radius * radius) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            result.push_back(node.userData);
+        }
+        else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void SpatialIndex::queryRay(const Vec3& origin, const Vec3& direction, float maxDistance,
+                            std::vector<RayHit>& result) const {
+    result.clear();
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    //  :   . ,  ,  
+    // ,      ,   ,  
+    // (     0 * inf = NaN     )
+    Vec3 inverse(direction.x != 0.0f ? 1.0f / direction.x : 0.0f,
+                 direction.y != 0.0f ? 1.0f / direction.y : 0.0f,
+                 direction.z != 0.0f ? 1.0f / direction.z : 0.0f);
+
+    auto clipSlab = [](float minBound, float maxBound, float start, float step, float inverseStep,
+                       float& tMin, float& tMax) {
+        if (step == 0.0f) {
+            return start >= minBound && start <= maxBound;
+        }
+        float t1 = (minBound - start) * inverseStep, t2 = (maxBound - start) * inverseStep;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+        return true;
+    };
+
+    auto entryDistance = [&](const AABB& box, float& tEnter) {
+        float tMin = 0.0f, tMax = maxDistance;
+        if (!clipSlab(box.min.x, box.max.x, origin.x, direction.x, inverse.x, tMin, tMax)
+            || !clipSlab(box.min.y, box.max.y, origin.y, direction.y, inverse.y, tMin, tMax)
+            || !clipSlab(box.min.z, box.max.z, origin.z, direction.z, inverse.z, tMin, tMax)) {
+            return false;
+        }
+
+        tEnter = tMin;
+        return tMax >= tMin;
+    };
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+
+        float tEnter;
+        if (!entryDistance(node.bounds, tEnter)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            result.push_back({ node.userData, tEnter });
+        }
+        else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+
+    //    (   )
+    std::sort(result.begin(), result.end(),
+              [](const RayHit& a, const RayHit& b) { return a.distance < b.distance; });
+}
@@ -0,0 +1,176 @@
+#include "../include/StreamBuffer.h"
+#include "../include/GLStateCache.h"
+#include <iostream>
+
+// ----------------------------------------------------------------------
+//   
+// ----------------------------------------------------------------------
+
+StreamBuffer::StreamBuffer(GLenum bufferTarget, GLsizeiptr regionSize)
+    : target(bufferTarget), frameSize(regionSize)
+{
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) {
+        uniformAlignment = alignment;
+    }
+
+    createStorage();
+}
+
+StreamBuffer::~StreamBuffer() {
+    releaseStorage();
+
+    if (overflowBufferID != 0) {
+        GLStateCache::get().forgetBuffer(overflowBufferID);
+        glDeleteBuffers(1, &overflowBufferID);
+    }
+}
+
+void StreamBuffer::createStorage() {
+    GLsizeiptr totalSize = frameSize * FRAMES_IN_FLIGHT;
+    glGenBuffers(1, &bufferID);
+    GLStateCache& state = GLStateCache::get();
+    state.bindBuffer(target, bufferID);
+
+    if (GLEW_ARB_buffer_storage) {
+        //  ,        
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, totalSize, nullptr, flags);
+        mapped = static_cast<char*>(glMapBufferRange(target, 0, totalSize, flags));
+        persistent = mapped != nullptr;
+    }
+
+    if (!persistent) {
+        glBufferData(target, totalSize, nullptr, GL_STREAM_DRAW);
+        shadow.resize(static_cast<size_t>(totalSize));
+    }
+
+    std::cout << "INFO::STREAM_BUFFER: " << totalSize / 1024 << " KB ring, " << FRAMES_IN_FLIGHT << " frames in flight, "
+              << (persistent ? "persistently mapped (ARB_buffer_storage)." : "orphaning fallback.") << std::endl;
+}
+
+void StreamBuffer::releaseStorage() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (bufferID != 0) {
+        GLStateCache& state = GLStateCache::get();
+        if (persistent) {
+            state.bindBuffer(target, bufferID);
+            glUnmapBuffer(target);
+        }
+        state.forgetBuffer(bufferID);
+        glDeleteBuffers(1, &bufferID);
+        bufferID = 0;
+    }
+    mapped = nullptr;
+    persistent = false;
+}
+
+void StreamBuffer::reserve(GLsizeiptr regionSize) {
+    if (regionSize <= frameSize) {
+        return;
+    }
+
+    //  ,      ,   -    
+    releaseStorage();
+    frameSize = regionSize;
+    createStorage();
+    frameIndex = FRAMES_IN_FLIGHT - 1;
+    cursor = 0;
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+void StreamBuffer::waitForRegion(int region) {
+    GLsync& fence = fences[region];
+    if (!fence) {
+        return;
+    }
+
+    //    :  FRAMES_IN_FLIGHT       
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        stats.stalls++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::beginFrame() {
+    frameIndex = (frameIndex + 1) % FRAMES_IN_FLIGHT;
+    cursor = 0;
+
+    if (persistent) {
+        waitForRegion(frameIndex);
+    }
+    else if (frameIndex == 0) {
+        //  :    ,      
+        GLStateCache::get().bindBuffer(target, bufferID);
+        glBufferData(target, frameSize * FRAMES_IN_FLIGHT, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+void StreamBuffer::endFrame() {
+    if (persistent) {
+        fences[frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+// ----------------------------------------------------------------------
+// 
+// ----------------------------------------------------------------------
+
+StreamBuffer::Allocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    GLsizeiptr aligned = alignment > 1 ? ((cursor + alignment - 1) / alignment) * alignment : cursor;
+    if (aligned + size > frameSize) {
+        stats.overflows++;
+        return Allocation();
+    }
+    cursor = aligned + size;
+
+    Allocation allocation;
+    allocation.offset = frameSize * frameIndex + aligned;
+    allocation.size = size;
+    allocation.data = (persistent ? mapped : shadow.data()) + allocation.offset;
+
+    stats.allocations++;
+    stats.bytes += static_cast<size_t>(size);
+    return allocation;
+}
+
+void StreamBuffer::flush(const Allocation& allocation) {
+    if (persistent || !allocation.data) {
+        return; //  :    GPU
+    }
+
+    GLStateCache::get().bindBuffer(target, bufferID);
+    glBufferSubData(target, allocation.offset, allocation.size, allocation.data);
+}
+
+void StreamBuffer::bindRange(GLuint bindingIndex, const Allocation& allocation) const {
+    GLStateCache::get().bindBufferRange(target, bindingIndex, bufferID, allocation.offset, allocation.size);
+}
+
+void StreamBuffer::uploadOverflow(GLuint bindingIndex, const void* data, GLsizeiptr size) {
+    GLStateCache& state = GLStateCache::get();
+    if (overflowBufferID == 0) {
+        glGenBuffers(1, &overflowBufferID);
+    }
+
+    //     :    ,   
+    state.bindBuffer(target, overflowBufferID);
+    glBufferData(target, size, data, GL_STREAM_DRAW);
+    state.bindBufferRange(target, bindingIndex, overflowBufferID, 0, size);
+}
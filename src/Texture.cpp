@@ -1,4 +1,5 @@
 #include "../include/Texture.h"
+#include "../include/GLStateCache.h"
 #include <algorithm> //  std::swap
 
 // ----------------------------------------------------------------------
@@ -22,6 +23,27 @@ Texture::Texture(const std::string& filePath, bool flipVertically)
     loadFromImage(image);
 }
 
+Texture::Texture(int width, int height, GLenum internalFormat, GLenum format, const float* pixels, GLint filter)
+    : textureID(0)
+{
+    glGenTextures(1, &textureID);
+    GLStateCache& state = GLStateCache::get();
+    state.bindTexture(0, textureID);
+
+    //     ,   4 
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    //      [0, 1]:     mipmap
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    state.bindTexture(0, 0);
+}
+
 //  
 Texture::Texture(Texture&& other) noexcept
     : textureID(other.textureID)
@@ -51,6 +73,7 @@ Texture::~Texture() {
 
 void Texture::cleanUp() {
     if (textureID != 0) {
+        GLStateCache::get().forgetTexture(textureID);
         glDeleteTextures(1, &textureID);
     }
 }
@@ -63,8 +86,9 @@ void Texture::loadFromImage(const sf::Image& image) {
     // 1.    OpenGL
     glGenTextures(1, &textureID);
 
-    // 2.  
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    // 2.   (    0)
+    GLStateCache& state = GLStateCache::get();
+    state.bindTexture(0, textureID);
 
     // 3.     
 
@@ -99,7 +123,7 @@ void Texture::loadFromImage(const sf::Image& image) {
     glGenerateMipmap(GL_TEXTURE_2D);
 
     // 6.  
-    glBindTexture(GL_TEXTURE_2D, 0);
+    state.bindTexture(0, 0);
 }
 
 void Texture::bind(unsigned int textureUnit) const {
@@ -107,10 +131,7 @@ void Texture::bind(unsigned int textureUnit) const {
         return;
     }
 
-    // 1.     (0 -  )
-    // GL_TEXTURE0, GL_TEXTURE1, ...
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-
-    // 2.     
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    //   (GL_TEXTURE0 + textureUnit)   .
+    //    ,       
+    GLStateCache::get().bindTexture(textureUnit, textureID);
 }
\ No newline at end of file
@@ -10,10 +10,15 @@ out vec3 FragPos;      // 
 out vec3 Normal;       //    
 out vec2 TexCoords;    //  
 
-// --- Uniform- (  ) ---
+// --- Uniform- ( ) ---
 uniform mat4 model;       //   ( -> )
-uniform mat4 view;        //   ( -> )
-uniform mat4 projection;  //   ( -> )
+
+// ---   (uniform- , . FrameUniforms;   .frag) ---
+layout(std140) uniform CameraData {
+    mat4 view;        //   ( -> )
+    mat4 projection;  //   ( -> )
+    vec3 viewPos;
+};
 
 void main()
 {
@@ -8,8 +8,14 @@ in vec2 TexCoords;
 // ---   ---
 out vec4 FragColor;
 
-// --- Uniform- ---
-uniform vec3 viewPos; 
+//    #define  #version (. ShaderVariantKey)
+
+// ---   (uniform- , . FrameUniforms;   base.vert) ---
+layout(std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
 
 // ---   (   phong.frag) ---
 struct DirLight {
@@ -17,7 +23,6 @@ struct DirLight {
     vec3 color;            
     float ambientIntensity; 
 };
-uniform DirLight dirLight;
 
 struct PointLight {
     vec3 position;  
@@ -27,8 +32,11 @@ struct PointLight {
     float quadratic;
 };
 #define MAX_POINT_LIGHTS 4
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform int numPointLights; 
+#ifdef NUM_POINT_LIGHTS
+#define POINT_LIGHT_COUNT NUM_POINT_LIGHTS
+#else
+#define POINT_LIGHT_COUNT numPointLights
+#endif
 
 struct SpotLight {
     vec3 position;
@@ -41,26 +49,81 @@ struct SpotLight {
     float quadratic;
 };
 #define MAX_SPOT_LIGHTS 2
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
-uniform int numSpotLights; 
+#ifdef NUM_SPOT_LIGHTS
+#define SPOT_LIGHT_COUNT NUM_SPOT_LIGHTS
+#else
+#define SPOT_LIGHT_COUNT numSpotLights
+#endif
+
+// ---   (uniform- ,  std140 - . FrameUniforms::LightBlock) ---
+layout(std140) uniform LightData {
+    DirLight dirLight;
+    PointLight pointLights[MAX_POINT_LIGHTS];
+    SpotLight spotLights[MAX_SPOT_LIGHTS];
+    int numPointLights;
+    int numSpotLights;
+};
+
+// ---    ( CLUSTERED_LIGHTING): . LightClusters ---
+#ifdef CLUSTERED_LIGHTING
+layout(std140) uniform ClusterData {
+    uvec4 clusterGrid;      //    x, y, z
+    vec4 clusterTileSize;   //     (xy)
+    vec4 clusterDepthSlice; // near, far, scale, bias:  = log() * scale + bias
+};
+uniform samplerBuffer clusterLights;        // 4   
+uniform usamplerBuffer clusterRanges;       //     
+uniform usamplerBuffer clusterLightIndices; //    
+
+int findCluster() {
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    uint slice = uint(max(log(viewDepth) * clusterDepthSlice.z + clusterDepthSlice.w, 0.0));
+    uvec3 cell = min(uvec3(uvec2(gl_FragCoord.xy / clusterTileSize.xy), slice), clusterGrid.xyz - 1u);
+    return int((cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x);
+}
+
+PointLight fetchPointLight(int base) {
+    vec4 t1 = texelFetch(clusterLights, base + 1);
+    return PointLight(texelFetch(clusterLights, base).xyz, t1.rgb, t1.w,
+                      texelFetch(clusterLights, base + 2).w, texelFetch(clusterLights, base + 3).x);
+}
+
+SpotLight fetchSpotLight(int base) {
+    vec4 t1 = texelFetch(clusterLights, base + 1);
+    vec4 t2 = texelFetch(clusterLights, base + 2);
+    vec4 t3 = texelFetch(clusterLights, base + 3);
+    return SpotLight(texelFetch(clusterLights, base).xyz, t2.xyz, t1.rgb, t3.y, t3.z, t1.w, t2.w, t3.x);
+}
+#endif
 
-// ---   ---
-struct Material {
+// ---   (uniform-,  std140 - . MaterialTable::EntryBlock) ---
+struct MaterialEntry {
     vec3 ambient;
+    float shininess; //    Roughness ()
     vec3 diffuse;
+    int lightingModel;
     vec3 specular;
-    float shininess; //    Roughness ()
-    sampler2D texture_diffuse1; 
+    bool textured;
+};
+//     MAX_MATERIALS  Shader.h
+#define MAX_MATERIALS 256
+layout(std140) uniform MaterialData {
+    MaterialEntry materials[MAX_MATERIALS];
 };
-uniform Material material;
+uniform int materialIndex;          //    
+uniform int culledLights;           //   LightData,     (. Scene::cullObjectLights)
+uniform sampler2D texture_diffuse1;
 
-// ---    Oren-Nayar Diffuse ---
-vec3 calculateOrenNayarDiffuse(vec3 lightDir, vec3 lightColor, vec3 fragNormal, float roughness) {
-    // Lambertian Diffuse ( Phong)
-    float diff = max(dot(fragNormal, lightDir), 0.0);
+//    (     main)
+MaterialEntry material;
 
-    //  Oren-Nayar:
-    
+// ---   Oren-Nayar (  CPU, . LightingLUT) ---
+// u = cos(theta_i), v = cos(theta_r) * 0.5 + 0.5;
+// : max(0, cos_i) * sin(alpha) * tan(alpha) / (sin(theta_i) * sin(theta_r))
+uniform sampler2D orenNayarLUT;
+
+// ---    Oren-Nayar Diffuse ---
+vec3 calculateOrenNayarDiffuse(vec3 lightDir, vec3 lightColor, vec3 fragNormal, vec3 viewDir, float roughness) {
     //  (alpha)  0  1. 
     // ,  material.shininess (0..100)   roughness (0..1)
     // float alpha = 1.0 - clamp(roughness / 100.0, 0.0, 1.0); // 
@@ -71,32 +134,20 @@ vec3 calculateOrenNayarDiffuse(vec3 lightDir, vec3 lightColor, vec3 fragNormal,
     float A = 1.0 - 0.5 * alphaSq / (alphaSq + 0.33);
     float B = 0.45 * alphaSq / (alphaSq + 0.09);
 
-    vec3 viewDir = normalize(viewPos - FragPos);
-    
     //   Oren-Nayar
     float cos_theta_i = dot(lightDir, fragNormal);
     float cos_theta_r = dot(viewDir, fragNormal);
     
-    // Sin(alpha) and Tan(alpha)
-    float sin_alpha, tan_alpha;
-    if (cos_theta_i > cos_theta_r) {
-        sin_alpha = length(lightDir - fragNormal * cos_theta_i);
-        tan_alpha = sin_alpha / cos_theta_i;
-    } else {
-        sin_alpha = length(viewDir - fragNormal * cos_theta_r);
-        tan_alpha = sin_alpha / cos_theta_r;
-    }
+    // cos(phi_diff) * sin(theta_i) * sin(theta_r) = dot(L, V) - cos_i * cos_r:
+    //         
+    float cos_phi_sin_sin = max(0.0, dot(lightDir, viewDir) - cos_theta_i * cos_theta_r);
 
-    // Cos(phi_diff)
-    vec3 v_perp = normalize(viewDir - fragNormal * cos_theta_r);
-    vec3 l_perp = normalize(lightDir - fragNormal * cos_theta_i);
-    float cos_phi_diff = dot(v_perp, l_perp);
+    //    (sin(alpha) * tan(alpha) / (sin_i * sin_r)) -  
+    float angular = texture(orenNayarLUT, vec2(cos_theta_i, cos_theta_r * 0.5 + 0.5)).r;
     
-    //   Oren-Nayar
-    float L_on = max(0.0, cos_theta_i) * (A + B * max(0.0, cos_phi_diff) * sin_alpha * tan_alpha);
+    //   Oren-Nayar ( cos_i <= 0   )
+    float L_on = max(0.0, cos_theta_i) * A + step(0.0, cos_theta_i) * B * cos_phi_sin_sin * angular;
 
-    //      ( )
-    //    L_on
     return lightColor * material.diffuse * L_on;
 }
 
@@ -109,12 +160,16 @@ vec3 calculateDirLight(DirLight light, vec3 norm, vec3 viewD) {
     vec3 ambient = light.color * material.ambient * light.ambientIntensity;
     
     // 2. Diffuse (Oren-Nayar)
-    vec3 diffuse = calculateOrenNayarDiffuse(lightDir, light.color, norm, material.shininess);
+    vec3 diffuse = calculateOrenNayarDiffuse(lightDir, light.color, norm, viewD, material.shininess);
     
     // 3. Specular (  Phong ,   Oren-Nayar   diffuse)
+#ifdef NO_SPECULAR
+    vec3 specular = vec3(0.0);
+#else
     vec3 reflectDir = normalize(reflect(-lightDir, norm));  
     float spec = pow(max(dot(viewD, reflectDir), 0.0), 32.0); //  specular
     vec3 specular = light.color * material.specular * spec;
+#endif
     
     return ambient + diffuse + specular;
 }
@@ -127,12 +182,16 @@ vec3 calculatePointLight(PointLight light, vec3 norm, vec3 viewD) {
     float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
     
     // Diffuse (Oren-Nayar)
-    vec3 diffuse = calculateOrenNayarDiffuse(lightDir, light.color, norm, material.shininess);
+    vec3 diffuse = calculateOrenNayarDiffuse(lightDir, light.color, norm, viewD, material.shininess);
     
     // Specular (Phong)
+#ifdef NO_SPECULAR
+    vec3 specular = vec3(0.0);
+#else
     vec3 reflectDir = normalize(reflect(-lightDir, norm));  
     float spec = pow(max(dot(viewD, reflectDir), 0.0), 32.0);
     vec3 specular = light.color * material.specular * spec;
+#endif
     
     // Ambient
     vec3 ambient = light.color * material.ambient;
@@ -154,12 +213,16 @@ vec3 calculateSpotLight(SpotLight light, vec3 norm, vec3 viewD) {
     if (theta <= light.outerCutOff) intensity = 0.0;
     
     // Diffuse (Oren-Nayar)
-    vec3 diffuse = calculateOrenNayarDiffuse(lightDir, light.color, norm, material.shininess);
+    vec3 diffuse = calculateOrenNayarDiffuse(lightDir, light.color, norm, viewD, material.shininess);
     
     // Specular (Phong)
+#ifdef NO_SPECULAR
+    vec3 specular = vec3(0.0);
+#else
     vec3 reflectDir = normalize(reflect(-lightDir, norm));  
     float spec = pow(max(dot(viewD, reflectDir), 0.0), 32.0);
     vec3 specular = light.color * material.specular * spec;
+#endif
     
     // Ambient
     vec3 ambient = light.color * material.ambient;
@@ -170,23 +233,46 @@ vec3 calculateSpotLight(SpotLight light, vec3 norm, vec3 viewD) {
 // ---   ---
 void main()
 {    
+    material = materials[materialIndex];
+
     vec3 norm = normalize(Normal);
     vec3 viewD = normalize(viewPos - FragPos);
     
-    vec4 texColor = texture(material.texture_diffuse1, TexCoords);
+#ifdef NO_TEXTURE
+    vec4 texColor = vec4(1.0);
+#else
+    vec4 texColor = texture(texture_diffuse1, TexCoords);
+#endif
     
     vec3 result = vec3(0.0);
     
     // 1.  
+#ifndef NO_DIR_LIGHT
     result += calculateDirLight(dirLight, norm, viewD);
+#endif
     
+#ifdef CLUSTERED_LIGHTING
+    // 2-3.       ( -  w  )
+    uvec2 range = texelFetch(clusterRanges, findCluster()).xy;
+    for(uint k = 0u; k < range.y; k++) {
+        int base = int(texelFetch(clusterLightIndices, int(range.x + k)).r) * 4;
+        if (texelFetch(clusterLights, base).w == 0.0)
+            result += calculatePointLight(fetchPointLight(base), norm, viewD);
+        else
+            result += calculateSpotLight(fetchSpotLight(base), norm, viewD);
+    }
+#else
     // 2.   
-    for(int i = 0; i < numPointLights; i++)
-        result += calculatePointLight(pointLights[i], norm, viewD);
+    // ( i -   i,  MAX_POINT_LIGHTS + i -  i;     )
+    for(int i = 0; i < POINT_LIGHT_COUNT; i++)
+        if ((culledLights & (1 << i)) == 0)
+            result += calculatePointLight(pointLights[i], norm, viewD);
         
     // 3. 
-    for(int i = 0; i < numSpotLights; i++)
-        result += calculateSpotLight(spotLights[i], norm, viewD);
+    for(int i = 0; i < SPOT_LIGHT_COUNT; i++)
+        if ((culledLights & (1 << (MAX_POINT_LIGHTS + i))) == 0)
+            result += calculateSpotLight(spotLights[i], norm, viewD);
+#endif
         
     //    ()
     FragColor = vec4(result, 1.0) * texColor;
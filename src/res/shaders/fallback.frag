@@ -0,0 +1,40 @@
+#version 330 core
+
+// ---   ---
+//    ,      .
+//   :      .
+
+// ---      ---
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+// ---   ---
+out vec4 FragColor;
+
+// ---   (uniform-,  std140 - . MaterialTable::EntryBlock) ---
+struct MaterialEntry {
+    vec3 ambient;
+    float shininess;
+    vec3 diffuse;
+    int lightingModel;
+    vec3 specular;
+    bool textured;
+};
+//     MAX_MATERIALS  Shader.h
+#define MAX_MATERIALS 256
+layout(std140) uniform MaterialData {
+    MaterialEntry materials[MAX_MATERIALS];
+};
+uniform int materialIndex;          //    
+
+//    (     main)
+MaterialEntry material;
+
+void main()
+{
+    material = materials[materialIndex];
+
+    float diff = max(dot(normalize(Normal), vec3(0.0, 1.0, 0.0)), 0.0) * 0.5 + 0.5;
+    FragColor = vec4(material.ambient + material.diffuse * diff, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#version 330 core
+
+// ---     (uber.vert +  , . Scene::addDeferredPasses) ---
+//    :    ,    
+// (deferred.frag).         ,
+//  G-   .
+
+// ---      ---
+#ifdef IMPOSTOR
+//    (impostor.vert):    ,   uber.frag
+in vec3 BillboardPos;
+in vec2 AtlasCoords;
+flat in mat3 ImpostorBasis;
+flat in vec3 ImpostorDepthAxis;
+vec3 FragPos;
+vec3 Normal;
+#else
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+#endif
+flat in int MaterialIndex;
+flat in int CulledLights;
+flat in float Fade;  //     (. uber.frag)
+
+// ---  G- ---
+layout (location = 0) out vec4 gPosition;  // xyz -  , w -  
+layout (location = 1) out vec4 gNormal;    // xyz -  , w - ,    
+layout (location = 2) out vec4 gAlbedo;    //   
+
+// ---   ( std140 - . MaterialTable::EntryBlock) ---
+struct MaterialEntry {
+    vec3 ambient;
+    float shininess;
+    vec3 diffuse;
+    int lightingModel;
+    vec3 specular;
+    bool textured;
+};
+//     MAX_MATERIALS  Shader.h
+#define MAX_MATERIALS 256
+layout(std140) uniform MaterialData {
+    MaterialEntry materials[MAX_MATERIALS];
+};
+
+//   (   )
+uniform sampler2D texture_diffuse1;
+
+// ---   <->  (  uber.frag) ---
+float ditherThreshold() {
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                      3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (bayer[p.y * 4 + p.x] + 0.5) / 16.0;
+}
+
+#ifdef IMPOSTOR
+// ---   (uniform- , . FrameUniforms):    ---
+layout(std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
+
+uniform sampler2D impostorAlbedo;
+uniform sampler2D impostorNormalDepth;
+
+vec4 fetchImpostorSurface() {
+    vec4 albedo = texture(impostorAlbedo, AtlasCoords);
+    if (albedo.a < 0.5 || ditherThreshold() >= Fade) discard;
+
+    vec4 normalDepth = texture(impostorNormalDepth, AtlasCoords);
+    Normal = ImpostorBasis * (normalDepth.xyz * 2.0 - 1.0);
+    FragPos = BillboardPos + ImpostorDepthAxis * (1.0 - 2.0 * normalDepth.w);
+
+    vec4 clip = projection * view * vec4(FragPos, 1.0);
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+    return vec4(albedo.rgb, 1.0);
+}
+#endif
+
+void main()
+{
+#ifdef IMPOSTOR
+    gAlbedo = fetchImpostorSurface();
+#else
+    if (Fade > 0.0 && ditherThreshold() < Fade) discard;
+    gAlbedo = materials[MaterialIndex].textured ? texture(texture_diffuse1, TexCoords) : vec4(1.0);
+#endif
+
+    //    MAX_MATERIALS     float
+    gPosition = vec4(FragPos, float(MaterialIndex));
+    gNormal = vec4(normalize(Normal), float(CulledLights));
+}
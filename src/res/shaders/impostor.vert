@@ -0,0 +1,89 @@
+#version 330 core
+
+// ---      (. ImpostorAtlas, Scene::setImpostorThreshold) ---
+//  :  -   (  4   gl_VertexID).
+//    ,        ,
+//        - ,     .
+//   - uber.frag  gbuffer.frag  #define IMPOSTOR.
+
+// ---   ---
+out vec3 BillboardPos;            //     (    )
+out vec2 AtlasCoords;             //   
+flat out mat3 ImpostorBasis;      //   ->  (   )
+flat out vec3 ImpostorDepthAxis;  //           
+flat out int MaterialIndex;
+flat out int CulledLights;
+flat out float Fade;              //       (. uber.frag)
+
+// ---   (  uber.vert;  std140 - Scene::UberInstance) ---
+#define MAX_UBER_INSTANCES 32
+struct InstanceEntry {
+    mat4 model;
+    int materialIndex;
+    int culledLights;
+    float impostorFade;
+};
+layout(std140) uniform InstanceData {
+    InstanceEntry instances[MAX_UBER_INSTANCES];
+};
+
+// ---   (uniform- , . FrameUniforms;   base.vert) ---
+layout(std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
+
+//      (   ImpostorAtlas::GRID)
+#define ATLAS_GRID 8
+
+//    :  (xyz)   (w)
+uniform vec4 impostorBounds;
+
+//  :  +Y -    [-1, 1]^2, -Y -  
+vec2 octEncode(vec3 d) {
+    vec2 p = d.xz / (abs(d.x) + abs(d.y) + abs(d.z));
+    if (d.y < 0.0) {
+        p = (1.0 - abs(p.yx)) * vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return p;
+}
+
+//  ,  ImpostorAtlas::frameDirection
+vec3 octDecode(vec2 p) {
+    vec3 d = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+    if (d.y < 0.0) {
+        d.xz = (1.0 - abs(p.yx)) * vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(d);
+}
+
+void main()
+{
+    mat4 model = instances[gl_InstanceID].model;
+    mat3 basis = mat3(model);
+    vec3 center = vec3(model * vec4(impostorBounds.xyz, 1.0));
+
+    // 1.       ->   
+    vec3 toViewer = normalize(inverse(basis) * (viewPos - center));
+    vec2 cell = min(floor((octEncode(toViewer) * 0.5 + 0.5) * float(ATLAS_GRID)), float(ATLAS_GRID - 1));
+    vec3 frameDir = octDecode((cell + 0.5) / float(ATLAS_GRID) * 2.0 - 1.0);
+
+    // 2.   -  ,     (ImpostorAtlas::bake)
+    vec3 right = normalize(vec3(frameDir.z, 0.0, -frameDir.x));
+    vec3 up = cross(frameDir, right);
+
+    // 3.   : (-1,-1), (1,-1), (-1,1), (1,1) -       
+    vec2 corner = vec2((gl_VertexID & 1) != 0 ? 1.0 : -1.0, (gl_VertexID & 2) != 0 ? 1.0 : -1.0);
+    vec3 local = impostorBounds.xyz + (corner.x * right + corner.y * up) * impostorBounds.w;
+    vec4 world = model * vec4(local, 1.0);
+
+    gl_Position = projection * view * world;
+    BillboardPos = world.xyz;
+    AtlasCoords = (cell + corner * 0.5 + 0.5) / float(ATLAS_GRID);
+    ImpostorBasis = basis;
+    ImpostorDepthAxis = basis * frameDir * impostorBounds.w;
+    MaterialIndex = instances[gl_InstanceID].materialIndex;
+    CulledLights = instances[gl_InstanceID].culledLights;
+    Fade = instances[gl_InstanceID].impostorFade;
+}
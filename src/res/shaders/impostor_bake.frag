@@ -0,0 +1,24 @@
+#version 330 core
+
+// ---     (impostor_bake.vert +  , . ImpostorAtlas::bake) ---
+//   :    ,   impostor.vert + uber.frag ( gbuffer.frag)
+//  .         .
+
+in vec3 Normal;
+in vec2 TexCoords;
+
+// ---   ---
+layout (location = 0) out vec4 outAlbedo;       //  ,  - 
+layout (location = 1) out vec4 outNormalDepth;  //  (  0..1)   
+
+//   ( ,   )
+uniform sampler2D texture_diffuse1;
+uniform bool bakeTextured;
+
+void main()
+{
+    outAlbedo = vec4(bakeTextured ? texture(texture_diffuse1, TexCoords).rgb : vec3(1.0), 1.0);
+
+    //   :      (0 -   )
+    outNormalDepth = vec4(normalize(Normal) * 0.5 + 0.5, gl_FragCoord.z);
+}
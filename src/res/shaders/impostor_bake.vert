@@ -0,0 +1,23 @@
+#version 330 core
+
+// ---     (. ImpostorAtlas::bake) ---
+//        ;      .
+
+// ---   ( ) ---
+layout (location = 0) in vec3 aPos;       //   ( )
+layout (location = 1) in vec3 aNormal;    //  
+layout (location = 2) in vec2 aTexCoords; //  
+
+// ---   ---
+out vec3 Normal;     //    
+out vec2 TexCoords;
+
+//        (  - ImpostorAtlas::frameDirection)
+uniform mat4 bakeViewProjection;
+
+void main()
+{
+    gl_Position = bakeViewProjection * vec4(aPos, 1.0);
+    Normal = aNormal;
+    TexCoords = aTexCoords;
+}
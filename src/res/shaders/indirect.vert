@@ -0,0 +1,59 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+// ---    GPU_DRIVEN (. IndirectRenderer) ---
+//     glMultiDrawElementsIndirect:   
+// drawBase + gl_DrawIDARB       .
+//     uber.vert,    - uber.frag.
+
+// ---   ( ) ---
+layout (location = 0) in vec3 aPos;       //   ( )
+layout (location = 1) in vec3 aNormal;    //  
+layout (location = 2) in vec2 aTexCoords; //  
+
+// ---   ---
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+flat out int MaterialIndex; //    
+flat out int CulledLights;  //  LightData,     (. Scene::cullObjectLights)
+flat out float Fade;        //       -   
+
+// ---   ( std430 - IndirectRenderer::ObjectRecord;   cull.comp) ---
+struct ObjectEntry {
+    mat4 model;            //  
+    vec4 boundingSphere;   //   :  (xyz)   (w)
+    uint meshIndex;        //   MeshData (   )
+    int materialIndex;
+    int culledLights;
+    uint pad;
+};
+layout(std430, binding = 0) readonly buffer ObjectData {
+    ObjectEntry objects[];
+};
+
+//      (gl_DrawIDARB      )
+uniform int drawBase;
+
+// ---   (uniform- , . FrameUniforms;   base.vert) ---
+layout(std140) uniform CameraData {
+    mat4 view;        //   ( -> )
+    mat4 projection;  //   ( -> )
+    vec3 viewPos;
+};
+
+void main()
+{
+    int objectIndex = drawBase + gl_DrawIDARB;
+    mat4 model = objects[objectIndex].model;
+
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    FragPos = vec3(model * vec4(aPos, 1.0));
+
+    //    base.vert:   
+    Normal = mat3(model) * aNormal;
+    TexCoords = aTexCoords;
+    MaterialIndex = objects[objectIndex].materialIndex;
+    CulledLights = objects[objectIndex].culledLights;
+    Fade = 0.0;
+}
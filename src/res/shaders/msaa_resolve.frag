@@ -0,0 +1,20 @@
+#version 330 core
+
+// ---   MSAA (deferred.vert +  , . Scene::addAntialiasingPass) ---
+//   -    (  box-,   glBlitFramebuffer),
+//     :      .
+
+out vec4 FragColor;
+
+uniform sampler2DMS sceneColor;
+uniform int sampleCount;   //    (textureSamples()    GLSL 4.50)
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 sum = vec4(0.0);
+    for (int i = 0; i < sampleCount; i++) {
+        sum += texelFetch(sceneColor, pixel, i);
+    }
+    FragColor = sum / float(sampleCount);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+
+// --- -    (GL_ANY_SAMPLES_PASSED) ---
+//    :      (. OcclusionCuller),
+//     .
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(0.0);
+}
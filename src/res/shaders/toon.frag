@@ -8,8 +8,14 @@ in vec2 TexCoords;
 // ---   ---
 out vec4 FragColor;
 
-// --- Uniform- ---
-uniform vec3 viewPos; 
+//    #define  #version (. ShaderVariantKey)
+
+// ---   (uniform- , . FrameUniforms;   base.vert) ---
+layout(std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
 
 // ---   (   phong.frag) ---
 struct DirLight {
@@ -17,7 +23,6 @@ struct DirLight {
     vec3 color;            
     float ambientIntensity; 
 };
-uniform DirLight dirLight;
 
 struct PointLight {
     vec3 position;  
@@ -27,8 +32,11 @@ struct PointLight {
     float quadratic;
 };
 #define MAX_POINT_LIGHTS 4
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform int numPointLights; 
+#ifdef NUM_POINT_LIGHTS
+#define POINT_LIGHT_COUNT NUM_POINT_LIGHTS
+#else
+#define POINT_LIGHT_COUNT numPointLights
+#endif
 
 struct SpotLight {
     vec3 position;
@@ -41,34 +49,83 @@ struct SpotLight {
     float quadratic;
 };
 #define MAX_SPOT_LIGHTS 2
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
-uniform int numSpotLights; 
+#ifdef NUM_SPOT_LIGHTS
+#define SPOT_LIGHT_COUNT NUM_SPOT_LIGHTS
+#else
+#define SPOT_LIGHT_COUNT numSpotLights
+#endif
+
+// ---   (uniform- ,  std140 - . FrameUniforms::LightBlock) ---
+layout(std140) uniform LightData {
+    DirLight dirLight;
+    PointLight pointLights[MAX_POINT_LIGHTS];
+    SpotLight spotLights[MAX_SPOT_LIGHTS];
+    int numPointLights;
+    int numSpotLights;
+};
+
+// ---    ( CLUSTERED_LIGHTING): . LightClusters ---
+#ifdef CLUSTERED_LIGHTING
+layout(std140) uniform ClusterData {
+    uvec4 clusterGrid;      //    x, y, z
+    vec4 clusterTileSize;   //     (xy)
+    vec4 clusterDepthSlice; // near, far, scale, bias:  = log() * scale + bias
+};
+uniform samplerBuffer clusterLights;        // 4   
+uniform usamplerBuffer clusterRanges;       //     
+uniform usamplerBuffer clusterLightIndices; //    
+
+int findCluster() {
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    uint slice = uint(max(log(viewDepth) * clusterDepthSlice.z + clusterDepthSlice.w, 0.0));
+    uvec3 cell = min(uvec3(uvec2(gl_FragCoord.xy / clusterTileSize.xy), slice), clusterGrid.xyz - 1u);
+    return int((cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x);
+}
+
+PointLight fetchPointLight(int base) {
+    vec4 t1 = texelFetch(clusterLights, base + 1);
+    return PointLight(texelFetch(clusterLights, base).xyz, t1.rgb, t1.w,
+                      texelFetch(clusterLights, base + 2).w, texelFetch(clusterLights, base + 3).x);
+}
 
-// ---   ---
-struct Material {
+SpotLight fetchSpotLight(int base) {
+    vec4 t1 = texelFetch(clusterLights, base + 1);
+    vec4 t2 = texelFetch(clusterLights, base + 2);
+    vec4 t3 = texelFetch(clusterLights, base + 3);
+    return SpotLight(texelFetch(clusterLights, base).xyz, t2.xyz, t1.rgb, t3.y, t3.z, t1.w, t2.w, t3.x);
+}
+#endif
+
+// ---   (uniform-,  std140 - . MaterialTable::EntryBlock) ---
+struct MaterialEntry {
     vec3 ambient;
+    float shininess; //    Specular-
     vec3 diffuse;
+    int lightingModel;
     vec3 specular;
-    float shininess; //    Specular-
-    sampler2D texture_diffuse1; 
+    bool textured;
+};
+//     MAX_MATERIALS  Shader.h
+#define MAX_MATERIALS 256
+layout(std140) uniform MaterialData {
+    MaterialEntry materials[MAX_MATERIALS];
 };
-uniform Material material;
+uniform int materialIndex;          //    
+uniform int culledLights;           //   LightData,     (. Scene::cullObjectLights)
+uniform sampler2D texture_diffuse1;
 
-// ---   ---
-//    3 : , , .
-const float lightLevels[] = float[] (0.1, 0.4, 0.9);
+//    (     main)
+MaterialEntry material;
+
+// ---  toon- (  CPU   , . LightingLUT) ---
+// u =   max(dot(N, L), 0),  -  
+uniform sampler2D toonRampLUT;
 
 /**
  * @brief   ,    .
  */
 float quantize(float intensity) {
-    float result = lightLevels[0]; //  ()
-    for (int i = 0; i < lightLevels.length(); i++) {
-        if (intensity > lightLevels[i]) {
-            result = lightLevels[i];
-        }
-    }
-    return result;
+    return texture(toonRampLUT, vec2(intensity, 0.5)).r;
 }
 
 // ---      ---
@@ -88,11 +145,15 @@ vec3 calculateDirLight(DirLight light, vec3 norm, vec3 viewD) {
     vec3 finalDiffuse = diffuse * quantizedDiff;
     
     // 3. Specular (  )
+#ifdef NO_SPECULAR
+    vec3 specular = vec3(0.0);
+#else
     vec3 reflectDir = normalize(reflect(-lightDir, norm));  
     float spec = dot(viewD, reflectDir);
     //  ,     
     float specFactor = step(0.95, spec); // 1.0,  spec > 0.95,  0.0
     vec3 specular = light.color * material.specular * specFactor;
+#endif
     
     return ambient + finalDiffuse + specular;
 }
@@ -112,10 +173,14 @@ vec3 calculatePointLight(PointLight light, vec3 norm, vec3 viewD) {
     vec3 diffuse = light.color * material.diffuse * quantizedDiff;
     
     //  
+#ifdef NO_SPECULAR
+    vec3 specular = vec3(0.0);
+#else
     vec3 reflectDir = normalize(reflect(-lightDir, norm));  
     float spec = dot(viewD, reflectDir);
     float specFactor = step(0.95, spec);
     vec3 specular = light.color * material.specular * specFactor;
+#endif
     
     // Ambient ( )
     vec3 ambient = light.color * material.ambient;
@@ -142,10 +207,14 @@ vec3 calculateSpotLight(SpotLight light, vec3 norm, vec3 viewD) {
     vec3 diffuse = light.color * material.diffuse * quantizedDiff;
     
     //  
+#ifdef NO_SPECULAR
+    vec3 specular = vec3(0.0);
+#else
     vec3 reflectDir = normalize(reflect(-lightDir, norm));  
     float spec = dot(viewD, reflectDir);
     float specFactor = step(0.95, spec);
     vec3 specular = light.color * material.specular * specFactor;
+#endif
     
     // Ambient
     vec3 ambient = light.color * material.ambient;
@@ -156,23 +225,46 @@ vec3 calculateSpotLight(SpotLight light, vec3 norm, vec3 viewD) {
 // ---   ---
 void main()
 {    
+    material = materials[materialIndex];
+
     vec3 norm = normalize(Normal);
     vec3 viewD = normalize(viewPos - FragPos);
     
-    vec4 texColor = texture(material.texture_diffuse1, TexCoords);
+#ifdef NO_TEXTURE
+    vec4 texColor = vec4(1.0);
+#else
+    vec4 texColor = texture(texture_diffuse1, TexCoords);
+#endif
     
     vec3 result = vec3(0.0);
     
     // 1.  
+#ifndef NO_DIR_LIGHT
     result += calculateDirLight(dirLight, norm, viewD);
+#endif
     
+#ifdef CLUSTERED_LIGHTING
+    // 2-3.       ( -  w  )
+    uvec2 range = texelFetch(clusterRanges, findCluster()).xy;
+    for(uint k = 0u; k < range.y; k++) {
+        int base = int(texelFetch(clusterLightIndices, int(range.x + k)).r) * 4;
+        if (texelFetch(clusterLights, base).w == 0.0)
+            result += calculatePointLight(fetchPointLight(base), norm, viewD);
+        else
+            result += calculateSpotLight(fetchSpotLight(base), norm, viewD);
+    }
+#else
     // 2.   
-    for(int i = 0; i < numPointLights; i++)
-        result += calculatePointLight(pointLights[i], norm, viewD);
+    // ( i -   i,  MAX_POINT_LIGHTS + i -  i;     )
+    for(int i = 0; i < POINT_LIGHT_COUNT; i++)
+        if ((culledLights & (1 << i)) == 0)
+            result += calculatePointLight(pointLights[i], norm, viewD);
         
     // 3. 
-    for(int i = 0; i < numSpotLights; i++)
-        result += calculateSpotLight(spotLights[i], norm, viewD);
+    for(int i = 0; i < SPOT_LIGHT_COUNT; i++)
+        if ((culledLights & (1 << (MAX_POINT_LIGHTS + i))) == 0)
+            result += calculateSpotLight(spotLights[i], norm, viewD);
+#endif
         
     //    ()
     FragColor = vec4(result, 1.0) * texColor;
@@ -0,0 +1,282 @@
+#version 330 core
+
+// --- : Phong, Toon  Oren-Nayar    ---
+//      ,    
+//       .
+
+// ---      ---
+#ifdef IMPOSTOR
+//    (impostor.vert):     
+//   (. fetchImpostorSurface)      ,   
+in vec3 BillboardPos;
+in vec2 AtlasCoords;
+flat in mat3 ImpostorBasis;
+flat in vec3 ImpostorDepthAxis;
+vec3 FragPos;
+vec3 Normal;
+#else
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+#endif
+flat in int MaterialIndex;
+flat in int CulledLights;
+flat in float Fade;  //     (       ditherThreshold)
+
+// ---   ---
+out vec4 FragColor;
+
+// ---   (uniform- , . FrameUniforms;   base.vert) ---
+layout(std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
+
+// ---   (   phong.frag) ---
+struct DirLight {
+    vec3 direction;
+    vec3 color;
+    float ambientIntensity;
+};
+
+struct PointLight {
+    vec3 position;
+    vec3 color;
+    float constant;
+    float linear;
+    float quadratic;
+};
+#define MAX_POINT_LIGHTS 4
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    vec3 color;
+    float cutOff;
+    float outerCutOff;
+    float constant;
+    float linear;
+    float quadratic;
+};
+#define MAX_SPOT_LIGHTS 2
+
+// ---   (uniform- ,  std140 - . FrameUniforms::LightBlock) ---
+layout(std140) uniform LightData {
+    DirLight dirLight;
+    PointLight pointLights[MAX_POINT_LIGHTS];
+    SpotLight spotLights[MAX_SPOT_LIGHTS];
+    int numPointLights;
+    int numSpotLights;
+};
+
+// ---    ( CLUSTERED_LIGHTING): . LightClusters ---
+#ifdef CLUSTERED_LIGHTING
+layout(std140) uniform ClusterData {
+    uvec4 clusterGrid;      //    x, y, z
+    vec4 clusterTileSize;   //     (xy)
+    vec4 clusterDepthSlice; // near, far, scale, bias:  = log() * scale + bias
+};
+uniform samplerBuffer clusterLights;        // 4   
+uniform usamplerBuffer clusterRanges;       //     
+uniform usamplerBuffer clusterLightIndices; //    
+
+int findCluster() {
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    uint slice = uint(max(log(viewDepth) * clusterDepthSlice.z + clusterDepthSlice.w, 0.0));
+    uvec3 cell = min(uvec3(uvec2(gl_FragCoord.xy / clusterTileSize.xy), slice), clusterGrid.xyz - 1u);
+    return int((cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x);
+}
+
+PointLight fetchPointLight(int base) {
+    vec4 t1 = texelFetch(clusterLights, base + 1);
+    return PointLight(texelFetch(clusterLights, base).xyz, t1.rgb, t1.w,
+                      texelFetch(clusterLights, base + 2).w, texelFetch(clusterLights, base + 3).x);
+}
+
+SpotLight fetchSpotLight(int base) {
+    vec4 t1 = texelFetch(clusterLights, base + 1);
+    vec4 t2 = texelFetch(clusterLights, base + 2);
+    vec4 t3 = texelFetch(clusterLights, base + 3);
+    return SpotLight(texelFetch(clusterLights, base).xyz, t2.xyz, t1.rgb, t3.y, t3.z, t1.w, t2.w, t3.x);
+}
+#endif
+
+// ---   ---
+//  lightingModel    enum class LightingModel
+#define LIGHTING_PHONG  0
+#define LIGHTING_TOON   1
+#define LIGHTING_CUSTOM 2
+
+//  std140 - . MaterialTable::EntryBlock (   phong/toon/custom)
+struct MaterialEntry {
+    vec3 ambient;
+    float shininess;    //  CUSTOM_MODEL -  Oren-Nayar
+    vec3 diffuse;
+    int lightingModel;
+    vec3 specular;
+    bool textured;
+};
+//     MAX_MATERIALS  Shader.h
+#define MAX_MATERIALS 256
+layout(std140) uniform MaterialData {
+    MaterialEntry materials[MAX_MATERIALS];
+};
+
+//   (   )
+uniform sampler2D texture_diffuse1;
+
+// ---   (  toon.frag  custom.frag, . LightingLUT) ---
+uniform sampler2D toonRampLUT;
+uniform sampler2D orenNayarLUT;
+
+float quantize(float intensity) {
+    return texture(toonRampLUT, vec2(intensity, 0.5)).r;
+}
+
+// --- Oren-Nayar:   (  custom.frag) ---
+float orenNayar(vec3 lightDir, vec3 viewDir, vec3 norm, float roughness) {
+    float alphaSq = roughness * roughness;
+    float A = 1.0 - 0.5 * alphaSq / (alphaSq + 0.33);
+    float B = 0.45 * alphaSq / (alphaSq + 0.09);
+
+    float cos_theta_i = dot(lightDir, norm);
+    float cos_theta_r = dot(viewDir, norm);
+
+    float cos_phi_sin_sin = max(0.0, dot(lightDir, viewDir) - cos_theta_i * cos_theta_r);
+    float angular = texture(orenNayarLUT, vec2(cos_theta_i, cos_theta_r * 0.5 + 0.5)).r;
+
+    return max(0.0, cos_theta_i) * A + step(0.0, cos_theta_i) * B * cos_phi_sin_sin * angular;
+}
+
+/**
+ * @brief         .
+ *      (MaterialIndex - flat).
+ */
+vec3 shade(MaterialEntry m, vec3 lightDir, vec3 lightColor, vec3 norm, vec3 viewD) {
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 reflectDir = normalize(reflect(-lightDir, norm));
+
+    float diffuseFactor;
+    float specFactor;
+    if (m.lightingModel == LIGHTING_TOON) {
+        diffuseFactor = quantize(diff);
+        specFactor = step(0.95, dot(viewD, reflectDir));
+    }
+    else if (m.lightingModel == LIGHTING_CUSTOM) {
+        diffuseFactor = orenNayar(lightDir, viewD, norm, m.shininess);
+        specFactor = pow(max(dot(viewD, reflectDir), 0.0), 32.0);
+    }
+    else {
+        diffuseFactor = diff;
+        specFactor = pow(max(dot(viewD, reflectDir), 0.0), m.shininess);
+    }
+
+    return lightColor * m.diffuse * diffuseFactor + lightColor * m.specular * specFactor;
+}
+
+// ---      ---
+
+vec3 calculateDirLight(MaterialEntry m, DirLight light, vec3 norm, vec3 viewD) {
+    vec3 lightDir = normalize(-light.direction);
+    vec3 ambient = light.color * m.ambient * light.ambientIntensity;
+    return ambient + shade(m, lightDir, light.color, norm, viewD);
+}
+
+vec3 calculatePointLight(MaterialEntry m, PointLight light, vec3 norm, vec3 viewD) {
+    vec3 lightDir = normalize(light.position - FragPos);
+    float distance = length(light.position - FragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+    vec3 ambient = light.color * m.ambient;
+    return (ambient + shade(m, lightDir, light.color, norm, viewD)) * attenuation;
+}
+
+vec3 calculateSpotLight(MaterialEntry m, SpotLight light, vec3 norm, vec3 viewD) {
+    vec3 lightDir = normalize(light.position - FragPos);
+    float distance = length(light.position - FragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+    float theta = dot(lightDir, normalize(-light.direction));
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    if (theta <= light.outerCutOff) intensity = 0.0;
+
+    vec3 ambient = light.color * m.ambient;
+    return (ambient + shade(m, lightDir, light.color, norm, viewD)) * attenuation * intensity;
+}
+
+// ---   <->  ---
+
+//  0..1  (  4x4):    Fade   ,
+//    Fade,   -       
+float ditherThreshold() {
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                      3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (bayer[p.y * 4 + p.x] + 0.5) / 16.0;
+}
+
+#ifdef IMPOSTOR
+//   (, ), . ImpostorAtlas
+uniform sampler2D impostorAlbedo;
+uniform sampler2D impostorNormalDepth;
+
+//  FragPos  Normal        .
+//    ;       
+vec4 fetchImpostorSurface() {
+    vec4 albedo = texture(impostorAlbedo, AtlasCoords);
+    if (albedo.a < 0.5 || ditherThreshold() >= Fade) discard;
+
+    vec4 normalDepth = texture(impostorNormalDepth, AtlasCoords);
+    Normal = ImpostorBasis * (normalDepth.xyz * 2.0 - 1.0);
+    FragPos = BillboardPos + ImpostorDepthAxis * (1.0 - 2.0 * normalDepth.w);
+
+    //  ,    :      
+    vec4 clip = projection * view * vec4(FragPos, 1.0);
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+    return vec4(albedo.rgb, 1.0);
+}
+#endif
+
+// ---   ---
+void main()
+{
+    MaterialEntry m = materials[MaterialIndex];
+
+#ifdef IMPOSTOR
+    vec4 texColor = fetchImpostorSurface();
+#else
+    //  ,   
+    if (Fade > 0.0 && ditherThreshold() < Fade) discard;
+    vec4 texColor = m.textured ? texture(texture_diffuse1, TexCoords) : vec4(1.0);
+#endif
+
+    vec3 norm = normalize(Normal);
+    vec3 viewD = normalize(viewPos - FragPos);
+
+    vec3 result = calculateDirLight(m, dirLight, norm, viewD);
+
+#ifdef CLUSTERED_LIGHTING
+    // 2-3.       ( -  w  )
+    uvec2 range = texelFetch(clusterRanges, findCluster()).xy;
+    for(uint k = 0u; k < range.y; k++) {
+        int base = int(texelFetch(clusterLightIndices, int(range.x + k)).r) * 4;
+        if (texelFetch(clusterLights, base).w == 0.0)
+            result += calculatePointLight(m, fetchPointLight(base), norm, viewD);
+        else
+            result += calculateSpotLight(m, fetchSpotLight(base), norm, viewD);
+    }
+#else
+    // ,    ,  ( MAX_POINT_LIGHTS + i -  i)
+    for(int i = 0; i < numPointLights; i++)
+        if ((CulledLights & (1 << i)) == 0)
+            result += calculatePointLight(m, pointLights[i], norm, viewD);
+
+    for(int i = 0; i < numSpotLights; i++)
+        if ((CulledLights & (1 << (MAX_POINT_LIGHTS + i))) == 0)
+            result += calculateSpotLight(m, spotLights[i], norm, viewD);
+#endif
+
+    FragColor = vec4(result, 1.0) * texColor;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#version 330 core
+
+// ---   ( ) ---
+layout (location = 0) in vec3 aPos;       //   ( )
+layout (location = 1) in vec3 aNormal;    //  
+layout (location = 2) in vec2 aTexCoords; //  
+
+// ---   ---
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+flat out int MaterialIndex; //     (   )
+flat out int CulledLights;  //  LightData,     (. Scene::cullObjectLights)
+flat out float Fade;        //        (0 -  , . Scene::selectImpostors)
+
+// ---    ---
+//       (. StreamBuffer);  std140 - Scene::UberInstance.
+//     MAX_UBER_INSTANCES  Shader.h
+#define MAX_UBER_INSTANCES 32
+struct InstanceEntry {
+    mat4 model;         //   
+    int materialIndex;  //    
+    int culledLights;   //   
+    float impostorFade; //   (   1  )
+};
+layout(std140) uniform InstanceData {
+    InstanceEntry instances[MAX_UBER_INSTANCES];
+};
+
+// ---   (uniform- , . FrameUniforms;   base.vert) ---
+layout(std140) uniform CameraData {
+    mat4 view;        //   ( -> )
+    mat4 projection;  //   ( -> )
+    vec3 viewPos;
+};
+
+void main()
+{
+    //        gl_InstanceID
+    mat4 model = instances[gl_InstanceID].model;
+
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    FragPos = vec3(model * vec4(aPos, 1.0));
+
+    //    base.vert:   
+    Normal = mat3(model) * aNormal;
+    TexCoords = aTexCoords;
+    MaterialIndex = instances[gl_InstanceID].materialIndex;
+    CulledLights = instances[gl_InstanceID].culledLights;
+    Fade = instances[gl_InstanceID].impostorFade;
+}
\ No newline at end of file
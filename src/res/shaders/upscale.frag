@@ -0,0 +1,17 @@
+#version 330 core
+
+// ---     (deferred.vert +  , . Scene::addUpscalePass) ---
+//          (   );
+//          .
+
+out vec4 FragColor;
+
+uniform sampler2D sceneColor;
+uniform vec2 targetOrigin;  //      
+uniform vec2 targetSize;
+
+void main()
+{
+    vec2 uv = (gl_FragCoord.xy - targetOrigin) / targetSize;
+    FragColor = vec4(texture(sceneColor, uv).rgb, 1.0);
+}